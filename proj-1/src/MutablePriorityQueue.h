@@ -8,97 +8,222 @@
 #ifndef SRC_MUTABLEPRIORITYQUEUE_H_
 #define SRC_MUTABLEPRIORITYQUEUE_H_
 
+#include <utility>
 #include <vector>
 
 // using namespace std;
 
 /**
- * class T must have: (i) accessible field int queueIndex; (ii) operator< defined.
+ * class T must have: (i) accessible field int queueIndex; (ii) double get_priority() const,
+ * the key, read when x is inserted and when its key is decreased.
+ *
+ * The heaps below are interchangeable policies with the same interface.
+ * MutablePriorityQueue<T> is the default one, a d-ary heap of arity
+ * MUTABLE_QUEUE_ARITY.
  */
 
-template <class T>
-class MutablePriorityQueue {
-    std::vector<T*> H;
-    void heapifyUp(unsigned i);
-    void heapifyDown(unsigned i);
-    inline void set(unsigned i, T* x);
+// Fastest on most maps in resource/ (see resource/heap_policies.txt)
+#define MUTABLE_QUEUE_ARITY 8
+
+// ***** d-ary heap
+
+/**
+ * d-ary heap, 1-indexed like the original binary heap: slot 0 is a
+ * sentinel, so queueIndex 0 means x is not in the queue. The keys are kept inline next to the handles, so
+ * sifting compares adjacent doubles instead of dereferencing two T*; wider
+ * heaps are shallower and scan the children of a node in one cache line.
+ */
+template <class T, unsigned Arity = MUTABLE_QUEUE_ARITY>
+class DaryHeap {
+    static_assert(Arity >= 2, "a heap needs at least two children per node");
+
+    struct Node {
+        double key;
+        T* x;
+    };
+
+    std::vector<Node> H;
+
+    static unsigned parent(unsigned i) { return (i - 2) / Arity + 1; }
+    static unsigned firstChild(unsigned i) { return (i - 1) * Arity + 2; }
+
+    void heapifyUp(unsigned i, Node node);
+    void heapifyDown(unsigned i, Node node);
+    inline void set(unsigned i, Node node);
 public:
-    MutablePriorityQueue();
+    DaryHeap();
     void insert(T* x);
     T* extractMin();
     void decreaseKey(T* x);
-    bool empty();
+    bool empty() const;
 };
 
-// Index calculations
-#define parent(i) ((i) >> 1)  /* i / 2 */
-#define leftChild(i) ((i) << 1)  /* i * 2 */
-
-template <class T>
-MutablePriorityQueue<T>::MutablePriorityQueue() {
-    H.push_back(nullptr);
-    // indices will be used starting in 1
-    // to facilitate parent/child calculations
+template <class T, unsigned Arity>
+DaryHeap<T, Arity>::DaryHeap() {
+    H.push_back({0, nullptr});
 }
 
-template <class T>
-bool MutablePriorityQueue<T>::empty() {
+template <class T, unsigned Arity>
+bool DaryHeap<T, Arity>::empty() const {
     return H.size() == 1;
 }
 
-template <class T>
-T* MutablePriorityQueue<T>::extractMin() {
-    auto x = H[1];
+template <class T, unsigned Arity>
+T* DaryHeap<T, Arity>::extractMin() {
+    auto x = H[1].x;
     x->queueIndex = 0;
-    H[1] = H.back();
+    Node last = H.back();
     H.pop_back();
     if (!empty())
-        heapifyDown(1);
+        heapifyDown(1, last);
     return x;
 }
 
-template <class T>
-void MutablePriorityQueue<T>::insert(T *x) {
-    H.push_back(x);
-    heapifyUp(H.size()-1);
+template <class T, unsigned Arity>
+void DaryHeap<T, Arity>::insert(T* x) {
+    H.push_back({x->get_priority(), x});
+    heapifyUp(H.size() - 1, H.back());
 }
 
-template <class T>
-void MutablePriorityQueue<T>::heapifyUp(unsigned i) {
-    auto x = H[i];
-    while (i > 1 && *x < *H[parent(i)]) {
+template <class T, unsigned Arity>
+void DaryHeap<T, Arity>::decreaseKey(T* x) {
+    heapifyUp(x->queueIndex, {x->get_priority(), x});
+}
+
+template <class T, unsigned Arity>
+void DaryHeap<T, Arity>::heapifyUp(unsigned i, Node node) {
+    while (i > 1 && node.key < H[parent(i)].key) {
         set(i, H[parent(i)]);
         i = parent(i);
     }
-    set(i, x);
+    set(i, node);
 }
 
-template <class T>
-void MutablePriorityQueue<T>::decreaseKey(T *x) {
-    heapifyUp(x->queueIndex);
-}
-
-template <class T>
-void MutablePriorityQueue<T>::heapifyDown(unsigned i) {
-    auto x = H[i];
+template <class T, unsigned Arity>
+void DaryHeap<T, Arity>::heapifyDown(unsigned i, Node node) {
+    unsigned size = H.size();
     while (true) {
-        unsigned k = leftChild(i);
-        if (k >= H.size())
+        unsigned k = firstChild(i);
+        if (k >= size)
             break;
-        if (k+1 < H.size()  && *H[k+1] < *H[k])
-            k++; // right child of i
-        if ( ! (*H[k] < *x) )
+        unsigned end = k + Arity < size ? k + Arity : size;
+        unsigned best = k;
+        for (++k; k < end; ++k) {
+            if (H[k].key < H[best].key)
+                best = k;
+        }
+        if ( ! (H[best].key < node.key) )
             break;
-        set(i, H[k]);
-        i = k;
+        set(i, H[best]);
+        i = best;
     }
-    set(i, x);
+    set(i, node);
 }
 
+template <class T, unsigned Arity>
+void DaryHeap<T, Arity>::set(unsigned i, Node node) {
+    H[i] = node;
+    node.x->queueIndex = i;
+}
+
+// ***** Pairing heap
+
+/**
+ * Pairing heap over a pool of nodes, queueIndex being the node of x and
+ * -1 once x is extracted.
+ * Insertion and decreaseKey are O(1) melds, extractMin pairs up the
+ * children of the root in two passes. Nodes are never freed, as every
+ * search inserts a vertex at most once per queue.
+ */
 template <class T>
-void MutablePriorityQueue<T>::set(unsigned i, T * x) {
-    H[i] = x;
-    x->queueIndex = i;
+class PairingHeap {
+    struct Node {
+        double key;
+        T* x;
+        int child, sibling, prev; // prev is the parent of a first child
+    };
+
+    std::vector<Node> N;
+    std::vector<int> pairs;
+    int root = -1;
+
+    int meld(int a, int b);
+public:
+    void insert(T* x);
+    T* extractMin();
+    void decreaseKey(T* x);
+    bool empty() const;
+};
+
+template <class T>
+bool PairingHeap<T>::empty() const {
+    return root == -1;
+}
+
+template <class T>
+int PairingHeap<T>::meld(int a, int b) {
+    if (a == -1) return b;
+    if (b == -1) return a;
+    if (N[b].key < N[a].key) std::swap(a, b);
+    N[b].sibling = N[a].child;
+    N[b].prev = a;
+    if (N[a].child != -1) N[N[a].child].prev = b;
+    N[a].child = b;
+    return a;
+}
+
+template <class T>
+void PairingHeap<T>::insert(T* x) {
+    x->queueIndex = N.size();
+    N.push_back({x->get_priority(), x, -1, -1, -1});
+    root = meld(root, x->queueIndex);
+}
+
+template <class T>
+void PairingHeap<T>::decreaseKey(T* x) {
+    int n = x->queueIndex;
+    if (n == -1) return;
+    N[n].key = x->get_priority();
+    if (n == root) return;
+
+    int prev = N[n].prev, sibling = N[n].sibling;
+    if (N[prev].child == n) N[prev].child = sibling;
+    else N[prev].sibling = sibling;
+    if (sibling != -1) N[sibling].prev = prev;
+
+    N[n].sibling = N[n].prev = -1;
+    root = meld(root, n);
+}
+
+template <class T>
+T* PairingHeap<T>::extractMin() {
+    auto x = N[root].x;
+    x->queueIndex = -1;
+
+    pairs.clear();
+    for (int c = N[root].child; c != -1;) {
+        int next = N[c].sibling;
+        N[c].sibling = N[c].prev = -1;
+        pairs.push_back(c);
+        c = next;
+    }
+
+    // Left to right in pairs, then right to left into one tree
+    int tree = -1;
+    unsigned size = pairs.size();
+    for (unsigned i = 0; i + 1 < size; i += 2)
+        pairs[i / 2] = meld(pairs[i], pairs[i + 1]);
+    if (size % 2 == 1)
+        tree = pairs[size - 1];
+    for (unsigned i = size / 2; i-- > 0;)
+        tree = meld(pairs[i], tree);
+
+    root = tree;
+    return x;
 }
 
+// Default heap
+template <class T>
+using MutablePriorityQueue = DaryHeap<T, MUTABLE_QUEUE_ARITY>;
+
 #endif /* SRC_MUTABLEPRIORITYQUEUE_H_ */
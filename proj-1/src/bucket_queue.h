@@ -0,0 +1,147 @@
+#ifndef BUCKET_QUEUE_H___
+#define BUCKET_QUEUE_H___
+
+#include "snapshot.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+/**
+ * Monotone priority queues of (key, vertex) entries with integer keys, for
+ * the quantised searches. Monotone means no key pushed is smaller than the
+ * last key popped, which Dijkstra guarantees with non-negative weights.
+ * Like SearchContext's heap they never decrease keys: a vertex is pushed
+ * again instead, and the search skips the stale entries.
+ *
+ * Both queues have the interface of the other queues the search kernel
+ * takes (search_kernel.h), with integer keys. IntegerQueue below is the one
+ * picked at compile time.
+ */
+
+// ***** Radix heap
+
+/**
+ * Entries go in bucket i when their key first differs from the last key
+ * popped at bit i-1, bucket 0 holding the keys equal to it. Popping an
+ * empty bucket 0 redistributes the first non-empty bucket around its
+ * smallest key, and every entry moves down at most 32 times in all.
+ */
+class RadixHeap {
+public:
+    using entry_t = std::pair<unsigned, int>;
+
+private:
+    std::vector<entry_t> _buckets[33];
+    std::size_t _size = 0;
+    unsigned _last = 0;
+
+    static int bucket(unsigned key, unsigned last) {
+        return key == last ? 0 : 32 - __builtin_clz(key ^ last);
+    }
+
+public:
+    explicit RadixHeap(const Snapshot& snap) {}
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    void clear() {
+        for (auto& bucket : _buckets) bucket.clear();
+        _size = 0;
+        _last = 0;
+    }
+
+    void push(int v, unsigned key) {
+        assert(key >= _last);
+        _buckets[bucket(key, _last)].push_back({key, v});
+        ++_size;
+    }
+
+    entry_t pop() {
+        if (_buckets[0].empty()) {
+            int i = 1;
+            while (_buckets[i].empty()) ++i;
+
+            _last = _buckets[i][0].first;
+            for (const entry_t& entry : _buckets[i]) _last = std::min(_last, entry.first);
+
+            for (const entry_t& entry : _buckets[i]) {
+                _buckets[bucket(entry.first, _last)].push_back(entry);
+            }
+            _buckets[i].clear();
+        }
+
+        entry_t entry = _buckets[0].back();
+        _buckets[0].pop_back();
+        --_size;
+        return entry;
+    }
+};
+
+// ***** Dial's buckets
+
+/**
+ * One bucket per key, in a ring of max_quantised() + 1 buckets: every key in
+ * the queue is at most one edge past the smallest, so they never wrap onto
+ * each other. Popping walks the ring from the last key popped.
+ */
+class BucketQueue {
+public:
+    using entry_t = std::pair<unsigned, int>;
+
+private:
+    std::vector<std::vector<int>> _buckets;
+    std::size_t _size = 0;
+    std::size_t _cursor = 0;
+    unsigned _key = 0;
+
+public:
+    explicit BucketQueue(const Snapshot& snap): _buckets(snap.max_quantised() + 1) {}
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    void clear() {
+        if (_size > 0) {
+            for (auto& bucket : _buckets) bucket.clear();
+        }
+        _size = 0;
+        _cursor = 0;
+        _key = 0;
+    }
+
+    void push(int v, unsigned key) {
+        assert(key >= _key && key - _key < _buckets.size());
+        std::size_t slot = _cursor + (key - _key);
+        if (slot >= _buckets.size()) slot -= _buckets.size();
+        _buckets[slot].push_back(v);
+        ++_size;
+    }
+
+    entry_t pop() {
+        while (_buckets[_cursor].empty()) {
+            if (++_cursor == _buckets.size()) _cursor = 0;
+            ++_key;
+        }
+
+        int v = _buckets[_cursor].back();
+        _buckets[_cursor].pop_back();
+        --_size;
+        return {_key, v};
+    }
+};
+
+// Dial's buckets are the fastest on every map in resource/ (see
+// resource/integer_queues.txt). Define CAL_RADIX_HEAP to use the radix heap
+// instead, whose size does not grow with the heaviest edge.
+#ifdef CAL_RADIX_HEAP
+using IntegerQueue = RadixHeap;
+#else
+using IntegerQueue = BucketQueue;
+#endif
+
+#endif // BUCKET_QUEUE_H___
@@ -1,15 +1,22 @@
 #include "graph.h"
+#include "reachability.h"
+#include "hierarchy.h"
+#include "landmarks.h"
 
 Edge::Edge(int id, Vertex* source, Vertex* target, Road* road):
     _id(id), _source(source), _target(target), _road(road) {
-    _source->_out.insert(this);
-    _target->_in.insert(this);
+    _source->_out.push_back(this);
+    _target->_in.push_back(this);
 }
 
 int Edge::id() const {
     return _id;
 }
 
+int Edge::index() const {
+    return _index;
+}
+
 Vertex* Edge::source() const {
     return _source;
 }
@@ -33,11 +40,12 @@ bool Edge::is_clear() const {
 bool Edge::fix() {
     if (_accidented) {
         _accidented = false;
+        _graph->_changes.push_back(_index);
+        if (_graph->_reachability) _graph->_reachability->insert(this);
+        _graph->_hierarchy.reset();
+        _graph->_landmarks.reset();
         _graph->view_edge_reset(this);
-        _source->_out.insert(this);
-        _target->_in.insert(this);
-        _source->_acc_out.erase(this);
-        _target->_acc_in.erase(this);
+        _graph->invalidate_snapshot();
         return true;
     } else {
         return false;
@@ -47,11 +55,12 @@ bool Edge::fix() {
 bool Edge::accident() {
     if (!_accidented) {
         _accidented = true;
+        _graph->_changes.push_back(_index);
+        if (_graph->_reachability) _graph->_reachability->erase(this);
+        _graph->_hierarchy.reset();
+        _graph->_landmarks.reset();
         _graph->view_edge_reset(this);
-        _source->_out.erase(this);
-        _target->_in.erase(this);
-        _source->_acc_out.insert(this);
-        _target->_acc_in.insert(this);
+        _graph->invalidate_snapshot();
         return true;
     } else {
         return false;
@@ -59,13 +68,15 @@ bool Edge::accident() {
 }
 
 double Edge::length() const {
-    return _graph->distance(_source, _target);
+    return _graph->length(this);
 }
 
 void Edge::set_weight(double weight) {
-    _weight = weight;
+    _graph->_weights[_index] = weight;
+    _graph->_changes.push_back(_index);
+    _graph->invalidate_snapshot();
 }
 
 double Edge::get_weight() const {
-    return _weight;
+    return _graph->weight(this);
 }
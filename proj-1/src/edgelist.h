@@ -0,0 +1,155 @@
+#ifndef EDGELIST_H___
+#define EDGELIST_H___
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+
+class Edge;
+
+/**
+ * Small vector of edge pointers for a vertex's adjacency.
+ *
+ * Road network vertices have 2 to 4 edges each way, so the first
+ * inline_capacity edges live inside the EdgeList itself and only vertices
+ * of higher degree allocate. Edges are never removed: an accident only
+ * flags the edge, and ClearEdges below skips the flagged ones.
+ */
+class EdgeList {
+private:
+    static constexpr std::uint32_t inline_capacity = 4;
+
+    Edge** _data;
+    std::uint32_t _size = 0;
+    std::uint32_t _capacity = inline_capacity;
+    Edge* _inline[inline_capacity];
+
+public:
+    using const_iterator = Edge* const*;
+
+    EdgeList();
+    EdgeList(const EdgeList&) = delete;
+    EdgeList& operator=(const EdgeList&) = delete;
+    ~EdgeList();
+
+    void push_back(Edge* edge);
+
+    std::size_t size() const;
+    bool empty() const;
+    Edge* operator[](std::size_t i) const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+};
+
+inline EdgeList::EdgeList(): _data(_inline) {}
+
+inline EdgeList::~EdgeList() {
+    if (_data != _inline) delete[] _data;
+}
+
+inline void EdgeList::push_back(Edge* edge) {
+    if (_size == _capacity) {
+        Edge** data = new Edge*[2 * _capacity];
+        std::copy(_data, _data + _size, data);
+        if (_data != _inline) delete[] _data;
+        _data = data;
+        _capacity *= 2;
+    }
+    _data[_size++] = edge;
+}
+
+inline std::size_t EdgeList::size() const {
+    return _size;
+}
+
+inline bool EdgeList::empty() const {
+    return _size == 0;
+}
+
+inline Edge* EdgeList::operator[](std::size_t i) const {
+    return _data[i];
+}
+
+inline EdgeList::const_iterator EdgeList::begin() const {
+    return _data;
+}
+
+inline EdgeList::const_iterator EdgeList::end() const {
+    return _data + _size;
+}
+
+/**
+ * The clear edges of an EdgeList, in order, skipping the accidented ones as
+ * it is iterated. Reads the accident flags, so skip() is defined in graph.h
+ * next to Edge.
+ */
+class ClearEdges {
+public:
+    class const_iterator {
+    private:
+        EdgeList::const_iterator _it;
+        EdgeList::const_iterator _end;
+
+        inline void skip();
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Edge*;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Edge* const*;
+        using reference = Edge* const&;
+
+        const_iterator(EdgeList::const_iterator it, EdgeList::const_iterator end);
+
+        reference operator*() const;
+        const_iterator& operator++();
+        bool operator==(const const_iterator& other) const;
+        bool operator!=(const const_iterator& other) const;
+    };
+
+private:
+    const EdgeList& _list;
+
+public:
+    explicit ClearEdges(const EdgeList& list);
+
+    const_iterator begin() const;
+    const_iterator end() const;
+};
+
+inline ClearEdges::const_iterator::const_iterator(EdgeList::const_iterator it,
+                                                  EdgeList::const_iterator end):
+    _it(it), _end(end) {
+    skip();
+}
+
+inline ClearEdges::const_iterator::reference ClearEdges::const_iterator::operator*() const {
+    return *_it;
+}
+
+inline ClearEdges::const_iterator& ClearEdges::const_iterator::operator++() {
+    ++_it;
+    skip();
+    return *this;
+}
+
+inline bool ClearEdges::const_iterator::operator==(const const_iterator& other) const {
+    return _it == other._it;
+}
+
+inline bool ClearEdges::const_iterator::operator!=(const const_iterator& other) const {
+    return _it != other._it;
+}
+
+inline ClearEdges::ClearEdges(const EdgeList& list): _list(list) {}
+
+inline ClearEdges::const_iterator ClearEdges::begin() const {
+    return const_iterator(_list.begin(), _list.end());
+}
+
+inline ClearEdges::const_iterator ClearEdges::end() const {
+    return const_iterator(_list.end(), _list.end());
+}
+
+#endif // EDGELIST_H___
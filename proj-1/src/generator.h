@@ -0,0 +1,100 @@
+#ifndef GENERATOR_H___
+#define GENERATOR_H___
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <utility>
+
+/**
+ * Lazy sequence of T produced by a coroutine that co_yields them, until
+ * std::generator (C++23) is available.
+ *
+ * The coroutine starts suspended and runs up to its next co_yield every
+ * time the iterator is incremented, so the caller decides how far it goes:
+ * leaving the loop early, or destroying the generator, abandons the
+ * coroutine where it stands. Single pass and move-only.
+ */
+template <typename T>
+class generator {
+public:
+    struct promise_type {
+        const T* value = nullptr;
+        std::exception_ptr exception;
+
+        generator get_return_object() {
+            return generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+
+        std::suspend_always yield_value(const T& yielded) noexcept {
+            value = &yielded;
+            return {};
+        }
+
+        void return_void() {}
+        void unhandled_exception() { exception = std::current_exception(); }
+    };
+
+    using handle_t = std::coroutine_handle<promise_type>;
+
+    class iterator {
+        handle_t _handle;
+
+        void advance() {
+            _handle.resume();
+            if (_handle.done() && _handle.promise().exception) {
+                std::rethrow_exception(_handle.promise().exception);
+            }
+        }
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        iterator() = default;
+        explicit iterator(handle_t handle): _handle(handle) { advance(); }
+
+        reference operator*() const { return *_handle.promise().value; }
+        pointer operator->() const { return _handle.promise().value; }
+
+        iterator& operator++() {
+            advance();
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        bool operator==(std::default_sentinel_t) const { return !_handle || _handle.done(); }
+    };
+
+private:
+    handle_t _handle;
+
+    explicit generator(handle_t handle): _handle(handle) {}
+
+public:
+    generator(generator&& other) noexcept: _handle(std::exchange(other._handle, nullptr)) {}
+    generator& operator=(generator&& other) noexcept {
+        if (this != &other) {
+            if (_handle) _handle.destroy();
+            _handle = std::exchange(other._handle, nullptr);
+        }
+        return *this;
+    }
+    generator(const generator&) = delete;
+    generator& operator=(const generator&) = delete;
+
+    ~generator() {
+        if (_handle) _handle.destroy();
+    }
+
+    iterator begin() { return iterator(_handle); }
+    std::default_sentinel_t end() const { return {}; }
+};
+
+#endif // GENERATOR_H___
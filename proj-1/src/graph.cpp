@@ -1,56 +1,116 @@
 #include "graph.h"
+#include "snapshot.h"
+#include "spatial.h"
+#include "reachability.h"
+#include "hierarchy.h"
+#include "landmarks.h"
+#include "parallel.h"
 
 #include <cassert>
 #include <cmath>
+#include <cstdlib>
 
 bool Graph::within_bounds(int x, int y) const {
     return x >= 0 && y >= 0 && x <= _width && y <= _height;
 }
 
-Graph::Graph(int width, int height, double scale):
-    _gv(new GraphViewer(width, height, false)),
-    _width(width), _height(height), _scale(scale) {
+/**
+ * A headless graph never starts the GraphViewer, and all the view
+ * functions (view_*, animate_path, ...) do nothing.
+ */
+Graph::Graph(int width, int height, double scale, bool headless):
+    _gv(headless ? nullptr : new GraphViewer(width, height, false)),
+    _width(width), _height(height), _scale(scale), _seed(std::rand()) {
+    if (headless) return;
+
     _gv->createWindow(VIEW_WIDTH_DEFAULT, VIEW_HEIGHT_DEFAULT);
     _gv->defineVertexColor(COLOR_CLEAR);
     _gv->defineEdgeColor(COLOR_CLEAR);
     _gv->defineVertexSize(VIEW_VERTEX_SIZE_CLEAR);
 }
 
+/**
+ * The vertices, edges and roads are destroyed in bulk with their slabs.
+ */
 Graph::~Graph() {
-    _gv->closeWindow();
+    if (!headless()) _gv->closeWindow();
+}
 
-    for (auto element : V) {
-        delete element.second;
-    }
+bool Graph::headless() const {
+    return _gv == nullptr;
+}
 
-    for (auto element : E) {
-        delete element.second;
-    }
+double Graph::scale() const {
+    return _scale;
+}
+
+/**
+ * Changes the metres per coordinate unit, recomputing the edge lengths.
+ * Everything derived from the lengths or the scale is rebuilt on next use.
+ */
+void Graph::set_scale(double scale) {
+    _scale = scale;
 
-    for (auto element : R) {
-        delete element.second;
+    for (Edge* edge : E) {
+        _lengths[edge->_index] = distance(edge->_source, edge->_target);
     }
+
+    invalidate_snapshot();
+    _spatial.reset();
+    _hierarchy.reset();
+    _landmarks.reset();
+}
+
+void Graph::reserve(std::size_t vertices, std::size_t edges) {
+    V.reserve(vertices);
+    E.reserve(edges);
+    _lengths.reserve(edges);
+    _weights.reserve(edges);
+    _vertex_slab.reserve(vertices);
+    _edge_slab.reserve(edges);
 }
 
+/**
+ * Discards the search state of the last pointer-based query in O(1), by
+ * moving on to a new generation. Only when the counter wraps around are
+ * the vertices' stamps swept.
+ */
 void Graph::clear() const {
-    for (auto element : V) {
-        Vertex* vertex = element.second;
-        vertex->set_priority(0);
-        vertex->set_cost(0);
-        vertex->set_path(nullptr);
+    if (++_generation == 0) {
+        for (Vertex* vertex : V) {
+            vertex->_generation = 0;
+        }
+        _generation = 1;
     }
 }
 
+/**
+ * Constructs a vertex owned by the graph. Objects passed to add_vertex,
+ * add_edge and add_road must come from make_vertex, make_edge and
+ * make_road respectively.
+ */
+Vertex* Graph::make_vertex(int id, int x, int y) {
+    return _vertex_slab.create(id, x, y);
+}
+
 bool Graph::add_vertex(Vertex* vertex) {
     assert(vertex != nullptr && get_vertex(vertex->id()) == nullptr);
 
     if (!within_bounds(vertex->x(), vertex->y())) return false;
 
-    V[vertex->id()] = vertex;
-    _gv->addNode(vertex->id(), vertex->x(), vertex->y());
+    vertex->_index = V.size();
+    V.insert(vertex->id(), vertex);
+    invalidate_snapshot();
+    _spatial.reset();
+    _reachability.reset();
+    _hierarchy.reset();
+    _landmarks.reset();
     vertex->_graph = this;
 
-    view_vertex_reset(vertex);
+    if (!headless()) {
+        _gv->addNode(vertex->id(), vertex->x(), vertex->y());
+        view_vertex_reset(vertex);
+    }
 
     return true;
 }
@@ -62,35 +122,54 @@ double Graph::distance(Vertex* v1, Vertex* v2) const {
 }
 
 Vertex* Graph::get_vertex(int vid) const {
-    auto it = V.find(vid);
+    return V.get(vid);
+}
 
-    if (it == V.end()) {
-        return nullptr;
-    } else {
-        return it->second;
-    }
+std::size_t Graph::num_vertices() const {
+    return V.size();
+}
+
+Edge* Graph::make_edge(int id, Vertex* source, Vertex* target, Road* road) {
+    return _edge_slab.create(id, source, target, road);
 }
 
 bool Graph::add_edge(Edge* edge) {
     assert(edge != nullptr && get_edge(edge->id()) == nullptr);
 
-    E[edge->id()] = edge;
-    _gv->addEdge(edge->id(), edge->source()->id(), edge->target()->id(), EdgeType::DIRECTED);
+    edge->_index = E.size();
+    E.insert(edge->id(), edge);
+    _lengths.push_back(distance(edge->_source, edge->_target));
+    _weights.push_back(_lengths.back());
+    invalidate_snapshot();
+    _reachability.reset();
+    _hierarchy.reset();
+    _landmarks.reset();
     edge->_graph = this;
 
-    view_edge_reset(edge);
+    if (!headless()) {
+        _gv->addEdge(edge->id(), edge->source()->id(), edge->target()->id(), EdgeType::DIRECTED);
+        view_edge_reset(edge);
+    }
 
     return true;
 }
 
-Edge* Graph::get_edge(int eid) const {
-    auto it = E.find(eid);
+/**
+ * Edge lengths are computed once, when the edge is added.
+ */
+double Graph::length(const Edge* edge) const {
+    return _lengths[edge->_index];
+}
 
-    if (it == E.end()) {
-        return nullptr;
-    } else {
-        return it->second;
-    }
+/**
+ * Edge weights start out equal to the edge lengths.
+ */
+double Graph::weight(const Edge* edge) const {
+    return _weights[edge->_index];
+}
+
+Edge* Graph::get_edge(int eid) const {
+    return E.get(eid);
 }
 
 Edge* Graph::get_edge(int vsource, int vtarget) const {
@@ -104,37 +183,136 @@ Edge* Graph::get_edge(int vsource, int vtarget) const {
     }
 }
 
+Road* Graph::make_road(int id, std::string name, bool bothways) {
+    return _road_slab.create(id, name, bothways);
+}
+
 bool Graph::add_road(Road* road) {
-    assert(road != nullptr && get_edge(road->id()) == nullptr);
+    assert(road != nullptr && get_road(road->id()) == nullptr);
 
-    R[road->id()] = road;
+    R.insert(road->id(), road);
     road->_graph = this;
 
     return true;
 }
 
 Road* Graph::get_road(int rid) const {
-    auto it = R.find(rid);
+    return R.get(rid);
+}
 
-    if (it == R.end()) {
-        return nullptr;
-    } else {
-        return it->second;
+const IdMap<Road>& Graph::get_road_map() const {
+    return R;
+}
+
+/**
+ * Counter-based generator: a uniform double in [0, 1) that depends only on
+ * (seed, tick, edge id), so every edge can draw its number independently,
+ * and the draws do not change with the order the edges are stored in.
+ * This is the splitmix64 finaliser applied to a combination of the keys.
+ */
+static double random_unit(std::uint64_t seed, std::uint64_t tick, std::uint64_t id) {
+    std::uint64_t z = seed + 0x9e3779b97f4a7c15 * (tick + 1) + 0xd1b54a32d192ed03 * (id + 1);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    z = z ^ (z >> 31);
+    return (z >> 11) * 0x1.0p-53;
+}
+
+/**
+ * Restarts the traffic simulation with a new seed. Two graphs loaded from
+ * the same map and given the same seed regenerate identical weights.
+ */
+void Graph::seed(std::uint64_t seed) {
+    _seed = seed;
+    _tick = 0;
+}
+
+/**
+ * Advances the traffic simulation by one tick: every clear edge's weight
+ * moves to a random value in [weight/2, 3*weight/2), wrapped by its length.
+ * The edges are independent, so they are updated in parallel, and the
+ * result does not depend on the number of threads.
+ */
+void Graph::regenerate(unsigned threads) {
+    ++_tick;
+
+    parallel_for(E.size(), [&](std::size_t i) {
+        // Zero-length edges (coincident vertices) keep a zero weight.
+        if (E[i]->_accidented || _lengths[i] == 0) return;
+
+        double weight = _weights[i];
+        double rand = random_unit(_seed, _tick, E[i]->id()) * weight - weight / 2;
+        _weights[i] = std::fmod(rand + weight, _lengths[i]);
+    }, threads);
+
+    _dropped_changes += _changes.size();
+    _changes.clear();
+    for (std::size_t i = 0; i < E.size(); ++i) {
+        if (!E[i]->_accidented && _lengths[i] != 0) _changes.push_back(i);
     }
+
+    invalidate_snapshot();
 }
 
-const std::unordered_map<int, Road*>& Graph::get_road_map() const {
-    return R;
+/**
+ * Returns the CSR snapshot of the current edge set and weights, building it
+ * if anything changed since the last call. Not thread-safe: build it before
+ * handing it to concurrent queries.
+ */
+std::shared_ptr<const Snapshot> Graph::snapshot() const {
+    if (!_snapshot) {
+        _snapshot = std::make_shared<const Snapshot>(*this);
+    }
+    return _snapshot;
 }
 
-void Graph::regenerate() {
-    for (auto element : V) {
-        Vertex* vertex = element.second;
+void Graph::invalidate_snapshot() const {
+    _snapshot.reset();
+}
 
-        for (Edge* edge : vertex->_in) {
-            double weight = edge->get_weight();
-            double rand = std::fmod(std::rand(), weight) - weight / 2;
-            edge->set_weight(std::fmod(rand + weight, edge->length()));
-        }
+/**
+ * Returns the spatial index of the vertices, building it on first use.
+ * load_map builds it once the map is loaded.
+ */
+const SpatialGrid& Graph::spatial() const {
+    if (!_spatial) {
+        _spatial = std::make_unique<SpatialGrid>(*this);
+    }
+    return *_spatial;
+}
+
+/**
+ * Returns the reachability index of the clear edges, building it on first
+ * use. load_map builds it once the map is loaded, and from then on edge
+ * accidents and fixes update it in place.
+ */
+const Reachability& Graph::reachability() const {
+    if (!_reachability) {
+        _reachability = std::make_unique<Reachability>(*this);
+    }
+    return *_reachability;
+}
+
+/**
+ * Returns the contraction hierarchy of the clear edges, preprocessing it on
+ * first use and again after an edge is accidented or fixed. Preprocessing
+ * takes a while on the bigger maps, so nothing builds it eagerly.
+ */
+const ContractionHierarchy& Graph::hierarchy() const {
+    if (!_hierarchy) {
+        _hierarchy = std::make_unique<ContractionHierarchy>(*snapshot());
+    }
+    return *_hierarchy;
+}
+
+/**
+ * Returns the landmark distance tables by length of the clear edges,
+ * computing them on first use and again after an edge is accidented or
+ * fixed. Tables by weight go stale every tick, so they are not kept here.
+ */
+const Landmarks& Graph::landmarks() const {
+    if (!_landmarks) {
+        _landmarks = std::make_unique<Landmarks>(*snapshot());
     }
+    return *_landmarks;
 }
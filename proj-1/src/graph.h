@@ -3,12 +3,14 @@
 
 #include "graphviewer.h"
 #include "MutablePriorityQueue.h"
+#include "idmap.h"
+#include "edgelist.h"
+#include "slab.h"
 
-#include <unordered_map>
-#include <unordered_set>
 #include <vector>
 #include <string>
 #include <memory>
+#include <cstdint>
 
 #define VIEW_WIDTH_DEFAULT              ((int)600)
 #define VIEW_HEIGHT_DEFAULT             ((int)600)
@@ -38,6 +40,11 @@ class Graph;
 class Vertex;
 class Edge;
 class Road;
+class Snapshot;
+class SpatialGrid;
+class Reachability;
+class ContractionHierarchy;
+class Landmarks;
 
 extern std::unique_ptr<Graph> graph; // Singleton graph instance
 
@@ -50,17 +57,52 @@ protected:
     GraphViewer* const _gv;
     const int _width;
     const int _height;
-    const double _scale;
-    std::unordered_map<int, Vertex*> V;
-    std::unordered_map<int, Edge*> E;
-    std::unordered_map<int, Road*> R;
+    double _scale;
+    IdMap<Vertex> V;
+    IdMap<Edge> E;
+    IdMap<Road> R;
+
+    // The graph owns its vertices, edges and roads, allocated in these slabs
+    Slab<Vertex> _vertex_slab;
+    Slab<Edge> _edge_slab;
+    Slab<Road> _road_slab;
+
+    // Length and weight of every edge, indexed by edge storage index
+    std::vector<double> _lengths;
+    std::vector<double> _weights;
+
+    // Traffic regeneration is a pure function of (seed, tick, edge)
+    std::uint64_t _seed;
+    std::uint64_t _tick = 0;
+
+    // Storage indices of the edges whose weight or accident flag changed
+    // since the start of the last regenerate(). The older entries were
+    // dropped then, _dropped_changes of them in all.
+    std::vector<int> _changes;
+    std::size_t _dropped_changes = 0;
+
+    mutable std::shared_ptr<const Snapshot> _snapshot;
+    mutable std::unique_ptr<SpatialGrid> _spatial;
+    mutable std::unique_ptr<Reachability> _reachability;
+    mutable std::unique_ptr<ContractionHierarchy> _hierarchy;
+    mutable std::unique_ptr<Landmarks> _landmarks;
+
+    // Search state in a Vertex is valid only if stamped with this generation
+    mutable unsigned _generation = 1;
 
     bool within_bounds(int x, int y) const;
 
 public:
-    explicit Graph(int width, int height, double scale);
+    explicit Graph(int width, int height, double scale, bool headless = false);
     ~Graph();
 
+    bool headless() const;
+
+    double scale() const;
+    void set_scale(double scale);
+
+    void reserve(std::size_t vertices, std::size_t edges);
+
     // ***** GraphViewer CRUD
     void update() const;
     void reset() const;
@@ -98,34 +140,71 @@ public:
     // *****
 
     // ***** Vertex CRUD
+    Vertex* make_vertex(int id, int x, int y);
     bool add_vertex(Vertex* vertex);
 
     double distance(Vertex* v1, Vertex* v2) const;
 
     Vertex* get_vertex(int vid) const;
+    std::size_t num_vertices() const;
     // *****
 
     // ***** Edge CRUD
+    Edge* make_edge(int id, Vertex* source, Vertex* target, Road* road);
     bool add_edge(Edge* edge);
 
-    double length(Edge* edge) const;
+    double length(const Edge* edge) const;
+    double weight(const Edge* edge) const;
 
     Edge* get_edge(int eid) const;
     Edge* get_edge(int vsource, int vtarget) const;
     // *****
     
     // ***** Road CRUD
+    Road* make_road(int id, std::string name, bool bothways = false);
     bool add_road(Road* road);
 
     Road* get_road(int rid) const;
-    const std::unordered_map<int, Road*>& get_road_map() const;
+    const IdMap<Road>& get_road_map() const;
     // *****
     
-    void regenerate();
+    // ***** Traffic
+    void seed(std::uint64_t seed);
+    void regenerate(unsigned threads = 0);
+    // *****
+
+    // ***** Snapshot
+    // Adding vertices or edges, set_scale(), regenerate() and an edge's
+    // accident(), fix() or set_weight() drop the graph's snapshot. Whoever
+    // still holds it keeps it alive, unchanged, but must ask again for the
+    // current one.
+    std::shared_ptr<const Snapshot> snapshot() const;
+    void invalidate_snapshot() const;
+    // *****
+
+    // ***** Spatial index
+    const SpatialGrid& spatial() const;
+    // *****
+
+    // ***** Reachability index
+    const Reachability& reachability() const;
+    // *****
+
+    // ***** Contraction hierarchy
+    const ContractionHierarchy& hierarchy() const;
+    // *****
+
+    // ***** ALT landmarks, by length
+    const Landmarks& landmarks() const;
+    // *****
     
     friend class Vertex;
     friend class Edge;
     friend class Road;
+    friend class Snapshot;
+    friend class SpatialGrid;
+    friend class DStarLite;
+    friend class Reachability;
 };
 
 
@@ -134,16 +213,17 @@ class Vertex {
 protected:
     const int _id;
     const int _x, _y;
+    int _index = -1;
 
-    std::unordered_set<Edge*> _in;
-    std::unordered_set<Edge*> _out;
-    std::unordered_set<Edge*> _acc_in;
-    std::unordered_set<Edge*> _acc_out;
+    // All incident/outgoing edges, accidented ones included
+    EdgeList _in;
+    EdgeList _out;
 
     bool _accidented = false;
     Vertex* _path = nullptr;
     double _priority = 0, _cost = 0;
     int queueIndex = 0;
+    unsigned _generation = 0;
     
     Graph* _graph = nullptr;
 
@@ -152,6 +232,7 @@ public:
 
     // ***** Self CRUD
     int id() const;
+    int index() const;
     int x() const;
     int y() const;
 
@@ -172,13 +253,18 @@ public:
     std::size_t in_degree() const;
     std::size_t out_degree() const;
 
-    const std::unordered_set<Edge*>& incident() const;
-    const std::unordered_set<Edge*>& outgoing() const;
+    ClearEdges incident() const;
+    ClearEdges outgoing() const;
+    const EdgeList& all_incident() const;
+    const EdgeList& all_outgoing() const;
     // *****
 
     // ***** Algorithms
     double distance(Vertex* other) const;
 
+    bool is_current() const;
+    void touch();
+
     void set_path(Vertex* previous);
     void set_priority(double priority);
     void set_cost(double cost);
@@ -191,7 +277,8 @@ public:
     friend class Graph;
     friend class Edge;
     friend class Road;
-    friend class MutablePriorityQueue<Vertex>;
+    template <class T, unsigned Arity> friend class DaryHeap;
+    template <class T> friend class PairingHeap;
     friend bool operator<(const Vertex& v1, const Vertex& v2);
 };
 
@@ -202,9 +289,9 @@ protected:
     const int _id;
     Vertex* const _source;
     Vertex* const _target;
+    int _index = -1;
 
     bool _accidented = false;
-    double _weight = 0;
 
     Road* _road = nullptr;
 
@@ -215,6 +302,7 @@ public:
 
     // ***** Self CRUD
     int id() const;
+    int index() const;
     Vertex* source() const;
     Vertex* target() const;
     Road* road() const;
@@ -239,6 +327,10 @@ public:
     friend class Road;
 };
 
+inline void ClearEdges::const_iterator::skip() {
+    while (_it != _end && (*_it)->is_accidented()) ++_it;
+}
+
 
 
 class Road {
@@ -1,5 +1,6 @@
 #include "graph.h"
 #include "paths.h"
+#include "reachability.h"
 
 #include <cmath>
 #include <unordered_set>
@@ -24,11 +25,15 @@
 /**
  * In this sets we store the vertices and edges modified by any of the functions,
  * to be reset by Graph::reset()
+ *
+ * In headless mode every function in this file is a no-op.
  */
 static std::unordered_set<Vertex*> modified_vertex;
 static std::unordered_set<Edge*> modified_edge;
 
 void Graph::view_vertex_custom(Vertex* vertex, Color color) const {
+    if (headless()) return;
+
     _gv->setVertexColor(vertex->id(), color);
 
     _gv->setVertexSize(vertex->id(), VIEW_VERTEX_SIZE_CUSTOM);
@@ -37,6 +42,8 @@ void Graph::view_vertex_custom(Vertex* vertex, Color color) const {
 }
 
 void Graph::view_vertex_select(Vertex* vertex) const {
+    if (headless()) return;
+
     _gv->setVertexColor(vertex->id(), COLOR_SELECTED);
 
     _gv->setVertexSize(vertex->id(), VIEW_VERTEX_SIZE_SELECTED);
@@ -47,6 +54,8 @@ void Graph::view_vertex_select(Vertex* vertex) const {
 }
 
 void Graph::view_vertex_reset(Vertex* vertex) const {
+    if (headless()) return;
+
     _gv->setVertexColor(vertex->id(),
         vertex->is_clear() ? COLOR_CLEAR : COLOR_ACCIDENTED);
 
@@ -60,12 +69,16 @@ void Graph::view_vertex_reset(Vertex* vertex) const {
 }
 
 void Graph::view_vertex_label(Vertex* vertex, int label) const {
+    if (headless()) return;
+
     _gv->setVertexLabel(vertex->id(), std::to_string(label));
 
     modified_vertex.insert(vertex);
 }
 
 void Graph::view_edge_custom(Edge* edge, Color color) const {
+    if (headless()) return;
+
     _gv->setEdgeColor(edge->id(), color);
 
     _gv->setEdgeThickness(edge->id(), VIEW_EDGE_THICKNESS_CUSTOM);
@@ -74,6 +87,8 @@ void Graph::view_edge_custom(Edge* edge, Color color) const {
 }
 
 void Graph::view_edge_select(Edge* edge) const {
+    if (headless()) return;
+
     _gv->setEdgeColor(edge->id(), COLOR_SELECTED);
 
     _gv->setEdgeThickness(edge->id(), VIEW_EDGE_THICKNESS_SELECTED);
@@ -84,6 +99,8 @@ void Graph::view_edge_select(Edge* edge) const {
 }
 
 void Graph::view_edge_reset(Edge* edge) const {
+    if (headless()) return;
+
     _gv->setEdgeColor(edge->id(),
         edge->is_clear() ? COLOR_CLEAR : COLOR_ACCIDENTED);
 
@@ -97,12 +114,16 @@ void Graph::view_edge_reset(Edge* edge) const {
 }
 
 void Graph::view_edge_label(Edge* edge, int label) const {
+    if (headless()) return;
+
     _gv->setEdgeLabel(edge->id(), std::to_string(label));
 
     modified_edge.insert(edge);
 }
 
 void Graph::view_road(Road* road, int label) const {
+    if (headless()) return;
+
     // We cycle through this array to pick the colors.
     static constexpr std::size_t road_colors_n = 7;
     static std::size_t current_road_color = 0;
@@ -121,10 +142,14 @@ void Graph::view_road(Road* road, int label) const {
 }
 
 void Graph::update() const {
+    if (headless()) return;
+
     _gv->rearrange();
 }
 
 void Graph::reset() const {
+    if (headless()) return;
+
     for (Vertex* vertex : modified_vertex) {
         view_vertex_reset(vertex);
     }
@@ -137,66 +162,76 @@ void Graph::reset() const {
 }
 
 void Graph::show_all_vertex_ids() const {
-    for (auto element : V) {
-        int id = element.first;
+    if (headless()) return;
+
+    for (Vertex* vertex : V) {
+        int id = vertex->id();
         _gv->setVertexLabel(id, std::to_string(id));
     }
     update();
 }
 
 void Graph::hide_all_vertex_ids() const {
-    for (auto element : V) {
-        int id = element.first;
+    if (headless()) return;
+
+    for (Vertex* vertex : V) {
+        int id = vertex->id();
         _gv->clearVertexLabel(id);
     }
     update();
 }
 
 void Graph::show_all_edge_ids() const {
-    for (auto element : E) {
-        int id = element.first;
+    if (headless()) return;
+
+    for (Edge* edge : E) {
+        int id = edge->id();
         _gv->setEdgeLabel(id, std::to_string(id));
     }
     update();
 }
 
 void Graph::hide_all_edge_ids() const {
-    for (auto element : E) {
-        int id = element.first;
+    if (headless()) return;
+
+    for (Edge* edge : E) {
+        int id = edge->id();
         _gv->clearEdgeLabel(id);
     }
     update();
 }
 
 void Graph::color_reachable(Vertex* vertex) const {
-    paths::breadth_first_search(vertex);
+    if (headless()) return;
 
-    for (auto element : V) {
-        Vertex* vertex = element.second;
-        if (vertex->get_path() != nullptr) {
+    std::vector<bool> reachable = reachability().reachable(vertex);
+
+    for (Vertex* vertex : V) {
+        if (reachable[vertex->_index]) {
             view_vertex_custom(vertex, COLOR_REACHABLE);
         }
     }
     
     update();
-    clear();
 }
 
 void Graph::color_unreachable(Vertex* vertex) const {
-    paths::breadth_first_search(vertex);
+    if (headless()) return;
+
+    std::vector<bool> reachable = reachability().reachable(vertex);
 
-    for (auto element : V) {
-        Vertex* vertex = element.second;
-        if (vertex->get_path() == nullptr) {
+    for (Vertex* vertex : V) {
+        if (!reachable[vertex->_index]) {
             view_vertex_custom(vertex, COLOR_UNREACHABLE);
         }
     }
 
     update();
-    clear();
 }
 
 void Graph::animate_path(path_t path, int ms, Color color) const {
+    if (headless()) return;
+
     if (path.empty()) return;
 
     if (ms * path.size() > MAX_WAIT) {
@@ -212,6 +247,8 @@ void Graph::animate_path(path_t path, int ms, Color color) const {
 }
 
 void Graph::clear_path(path_t path, int ms) const {
+    if (headless()) return;
+
     if (path.empty()) return;
 
     if (ms * path.size() > MAX_WAIT) {
@@ -227,6 +264,8 @@ void Graph::clear_path(path_t path, int ms) const {
 }
 
 void Graph::reset_path(path_t path) const {
+    if (headless()) return;
+
     if (path.empty()) return;
 
     for (std::size_t i = 1; i < path.size(); ++i) {
@@ -237,14 +276,20 @@ void Graph::reset_path(path_t path) const {
 }
 
 void Graph::set_background(std::string path) const {
+    if (headless()) return;
+
     _gv->setBackground(path);
 }
 
 void Graph::straight_edges(bool val) const {
+    if (headless()) return;
+
     _gv->defineEdgeCurved(!val);
 }
 
 void Graph::show_boundaries() const {
+    if (headless()) return;
+
     int ID = -1337;
 
     // Corners
@@ -0,0 +1,553 @@
+#include "hierarchy.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <limits>
+#include <tuple>
+#include <utility>
+
+static constexpr double inf = std::numeric_limits<double>::infinity();
+
+// Searches are far heavier than the items parallel_for is tuned for
+#define HIERARCHY_MIN_BLOCK ((std::size_t)32)
+
+namespace {
+
+struct Arc {
+    int node;
+    double cost;
+    int middle;
+};
+
+struct Shortcut {
+    int source, target;
+    double cost;
+    int middle;
+};
+
+/**
+ * The remaining graph during preprocessing: adjacency lists of the
+ * vertices not yet contracted, with at most one arc per ordered pair.
+ */
+class Contractor {
+public:
+    std::vector<std::vector<Arc>> out, in;
+    std::vector<char> contracting;
+    std::vector<int> deleted;
+
+    explicit Contractor(const Snapshot& snap):
+        out(snap.size()), in(snap.size()), contracting(snap.size(), 0),
+        deleted(snap.size(), 0) {
+        for (int u = 0; u < (int)snap.size(); ++u) {
+            for (int e = snap.begin(u); e < snap.end(u); ++e) {
+                add_arc(u, snap.target(e), snap.length(e), -1);
+            }
+        }
+    }
+
+    /**
+     * Adds the arc u->w, or lowers the cost of the one already there.
+     * False if there was a cheaper (or equal) arc already.
+     */
+    bool add_arc(int u, int w, double cost, int middle) {
+        if (u == w) return false;
+
+        for (Arc& arc : out[u]) {
+            if (arc.node != w) continue;
+            if (arc.cost <= cost) return false;
+
+            arc.cost = cost;
+            arc.middle = middle;
+            for (Arc& back : in[w]) {
+                if (back.node == u) back = {u, cost, middle};
+            }
+            return true;
+        }
+
+        out[u].push_back({w, cost, middle});
+        in[w].push_back({u, cost, middle});
+        return true;
+    }
+
+    static void remove_arc(std::vector<Arc>& arcs, int node) {
+        arcs.erase(std::remove_if(arcs.begin(), arcs.end(), [node](const Arc& arc) {
+            return arc.node == node;
+        }), arcs.end());
+    }
+
+    /**
+     * Dijkstra from source that avoids skip and the vertices being
+     * contracted, up to cost limit or HIERARCHY_WITNESS_LIMIT settled
+     * vertices.
+     */
+    void witness(SearchContext& context, int source, double limit, int skip) const {
+        context.reset(source);
+        context.push(source, 0);
+
+        int settled = 0;
+
+        while (context.skip_stale()) {
+            auto [cost, current] = context.pop();
+            if (cost > limit || ++settled > HIERARCHY_WITNESS_LIMIT) break;
+
+            for (const Arc& arc : out[current]) {
+                if (arc.node == skip || contracting[arc.node]) continue;
+
+                auto newcost = cost + arc.cost;
+
+                if (!context.reached(arc.node) || newcost < context.get_cost(arc.node)) {
+                    context.set_cost(arc.node, newcost);
+                    context.set_path(arc.node, current);
+                    context.push(arc.node, newcost);
+                }
+            }
+        }
+    }
+
+    /**
+     * Calls emit(shortcut) for each shortcut that contracting v needs: the
+     * pairs u->v->w with no witness path as short that avoids v.
+     */
+    template <typename Emit>
+    void shortcuts(SearchContext& context, int v, const Emit& emit) const {
+        double furthest = 0;
+        for (const Arc& arc : out[v]) furthest = std::max(furthest, arc.cost);
+
+        for (const Arc& first : in[v]) {
+            int u = first.node;
+
+            witness(context, u, first.cost + furthest, v);
+
+            for (const Arc& second : out[v]) {
+                int w = second.node;
+                if (w == u) continue;
+
+                double cost = first.cost + second.cost;
+                if (!context.reached(w) || context.get_cost(w) > cost) {
+                    emit(Shortcut{u, w, cost, v});
+                }
+            }
+        }
+    }
+
+    /**
+     * Edge difference of contracting v, plus its deleted neighbours.
+     */
+    int priority(SearchContext& context, int v) const {
+        int added = 0;
+        shortcuts(context, v, [&added](const Shortcut&) { ++added; });
+
+        int removed = out[v].size() + in[v].size();
+        return added - removed + deleted[v];
+    }
+};
+
+}
+
+ContractionHierarchy::ContractionHierarchy(const Snapshot& snap, unsigned threads) {
+    int n = snap.size();
+    Contractor graph(snap);
+
+    _vertices.resize(n);
+    for (int v = 0; v < n; ++v) _vertices[v] = snap.vertex(v);
+
+    std::vector<SearchContext> contexts(parallel_threads(threads), SearchContext(n));
+    std::vector<int> priority(n);
+    std::vector<std::vector<Arc>> up(n), down(n);
+    std::vector<int> stamp(n, -1);
+
+    std::vector<int> remaining(n);
+    for (int v = 0; v < n; ++v) remaining[v] = v;
+
+    auto update_priorities = [&](const std::vector<int>& vertices) {
+        parallel_blocks(vertices.size(), [&](std::size_t block, std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                int v = vertices[i];
+                priority[v] = graph.priority(contexts[block], v);
+            }
+        }, threads, HIERARCHY_MIN_BLOCK);
+    };
+
+    update_priorities(remaining);
+
+    _rank.assign(n, -1);
+    int next_rank = 0;
+
+    while (!remaining.empty()) {
+        // Contract every vertex that comes before all of its neighbours.
+        auto before = [&](int u, int v) {
+            return std::tie(priority[u], u) < std::tie(priority[v], v);
+        };
+
+        std::vector<char> pick(remaining.size());
+        parallel_for(remaining.size(), [&](std::size_t i) {
+            int v = remaining[i];
+            bool minimum = true;
+            for (const Arc& arc : graph.out[v]) minimum = minimum && before(v, arc.node);
+            for (const Arc& arc : graph.in[v]) minimum = minimum && before(v, arc.node);
+            pick[i] = minimum;
+        }, threads);
+
+        std::vector<int> round;
+        for (std::size_t i = 0; i < remaining.size(); ++i) {
+            if (pick[i]) round.push_back(remaining[i]);
+        }
+        for (int v : round) graph.contracting[v] = 1;
+
+        // No two vertices of the round are adjacent, and the witness searches
+        // avoid all of them, so their shortcuts can be found in parallel.
+        std::vector<std::vector<Shortcut>> found(round.size());
+        parallel_blocks(round.size(), [&](std::size_t block, std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                graph.shortcuts(contexts[block], round[i], [&](const Shortcut& shortcut) {
+                    found[i].push_back(shortcut);
+                });
+            }
+        }, threads, HIERARCHY_MIN_BLOCK);
+
+        std::vector<int> touched;
+
+        for (int v : round) {
+            _rank[v] = next_rank++;
+            up[v] = std::move(graph.out[v]);
+            down[v] = std::move(graph.in[v]);
+
+            for (const Arc& arc : up[v]) Contractor::remove_arc(graph.in[arc.node], v);
+            for (const Arc& arc : down[v]) Contractor::remove_arc(graph.out[arc.node], v);
+
+            for (const auto* arcs : {&up[v], &down[v]}) {
+                for (const Arc& arc : *arcs) {
+                    if (stamp[arc.node] == v) continue;
+                    stamp[arc.node] = v;
+                    ++graph.deleted[arc.node];
+                    touched.push_back(arc.node);
+                }
+            }
+        }
+
+        for (const auto& shortcuts : found) {
+            for (const Shortcut& s : shortcuts) {
+                if (graph.add_arc(s.source, s.target, s.cost, s.middle)) ++_shortcuts;
+            }
+        }
+
+        for (int v : round) graph.contracting[v] = 0;
+
+        remaining.erase(std::remove_if(remaining.begin(), remaining.end(), [&](int v) {
+            return _rank[v] != -1;
+        }), remaining.end());
+
+        std::sort(touched.begin(), touched.end());
+        touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+        update_priorities(touched);
+    }
+
+    // Flatten the upward and downward arcs into CSR arrays.
+    _up_offsets.reserve(n + 1);
+    _down_offsets.reserve(n + 1);
+    _up_offsets.push_back(0);
+    _down_offsets.push_back(0);
+
+    for (int v = 0; v < n; ++v) {
+        for (const Arc& arc : up[v]) {
+            _up_targets.push_back(arc.node);
+            _up_costs.push_back(arc.cost);
+            _up_middles.push_back(arc.middle);
+        }
+        for (const Arc& arc : down[v]) {
+            _down_sources.push_back(arc.node);
+            _down_costs.push_back(arc.cost);
+            _down_middles.push_back(arc.middle);
+        }
+        _up_offsets.push_back(_up_targets.size());
+        _down_offsets.push_back(_down_sources.size());
+    }
+}
+
+std::size_t ContractionHierarchy::size() const {
+    return _vertices.size();
+}
+
+/**
+ * Number of upward and downward arcs, shortcuts included.
+ */
+std::size_t ContractionHierarchy::arcs() const {
+    return _up_targets.size() + _down_sources.size();
+}
+
+/**
+ * Number of shortcuts added by the preprocessing. Some of them may have
+ * been replaced by cheaper shortcuts for the same pair later on.
+ */
+std::size_t ContractionHierarchy::shortcuts() const {
+    return _shortcuts;
+}
+
+/**
+ * Position of v in the contraction order.
+ */
+int ContractionHierarchy::rank(int v) const {
+    return _rank[v];
+}
+
+/**
+ * Stall-on-demand: a vertex reached more cheaply from a higher ranked
+ * vertex, through an arc the search does not follow, lies on no shortest
+ * path and needs no expansion. For the forward search those are the
+ * downward arcs entering v, and for the backward search the upward arcs
+ * leaving v.
+ */
+static bool stalled(const SearchContext& context, const std::vector<int>& offsets,
+                    const std::vector<int>& nodes, const std::vector<double>& costs, int v) {
+    for (int e = offsets[v]; e < offsets[v + 1]; ++e) {
+        int u = nodes[e];
+        if (context.reached(u) && context.get_cost(u) + costs[e] < context.get_cost(v)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Bidirectional Dijkstra from source over the upward arcs and from target
+ * over the downward arcs. The shortest path climbs to its highest ranked
+ * vertex and then descends, so once a side's smallest key reaches the best
+ * path found it has nothing left to contribute. Returns the vertex where
+ * the best path meets, -1 if there is no path.
+ */
+int ContractionHierarchy::search(SearchContext& forward, SearchContext& backward,
+                                 int source, int target) const {
+    forward.reset(source);
+    backward.reset(target);
+    forward.push(source, 0);
+    backward.push(target, 0);
+
+    double best = inf;
+    int meet = -1;
+
+    if (source == target) {
+        best = 0;
+        meet = source;
+    }
+
+    while (true) {
+        bool forward_open = forward.skip_stale() && forward.top().first < best;
+        bool backward_open = backward.skip_stale() && backward.top().first < best;
+
+        if (!forward_open && !backward_open) break;
+
+        if (forward_open && (!backward_open || forward.top().first <= backward.top().first)) {
+            int current = forward.pop().second;
+            if (stalled(forward, _down_offsets, _down_sources, _down_costs, current)) continue;
+
+            for (int e = _up_offsets[current]; e < _up_offsets[current + 1]; ++e) {
+                int next = _up_targets[e];
+
+                auto newcost = forward.get_cost(current) + _up_costs[e];
+
+                if (!forward.reached(next) || newcost < forward.get_cost(next)) {
+                    forward.set_cost(next, newcost);
+                    forward.set_path(next, current);
+                    forward.push(next, newcost);
+
+                    if (backward.reached(next) && newcost + backward.get_cost(next) < best) {
+                        best = newcost + backward.get_cost(next);
+                        meet = next;
+                    }
+                }
+            }
+        } else {
+            int current = backward.pop().second;
+            if (stalled(backward, _up_offsets, _up_targets, _up_costs, current)) continue;
+
+            for (int e = _down_offsets[current]; e < _down_offsets[current + 1]; ++e) {
+                int next = _down_sources[e];
+
+                auto newcost = backward.get_cost(current) + _down_costs[e];
+
+                if (!backward.reached(next) || newcost < backward.get_cost(next)) {
+                    backward.set_cost(next, newcost);
+                    backward.set_path(next, current);
+                    backward.push(next, newcost);
+
+                    if (forward.reached(next) && newcost + forward.get_cost(next) < best) {
+                        best = newcost + forward.get_cost(next);
+                        meet = next;
+                    }
+                }
+            }
+        }
+    }
+
+    return meet;
+}
+
+/**
+ * Dijkstra over the upward arcs from source, or over the downward arcs
+ * backwards if backward, through its whole search space. Calls
+ * visit(v, cost) for every settled vertex that is not stalled.
+ */
+template <typename Visit>
+void ContractionHierarchy::upward(SearchContext& context, int source, bool backward,
+                                  const Visit& visit) const {
+    const auto& offsets = backward ? _down_offsets : _up_offsets;
+    const auto& nodes = backward ? _down_sources : _up_targets;
+    const auto& costs = backward ? _down_costs : _up_costs;
+
+    context.reset(source);
+    context.push(source, 0);
+
+    while (context.skip_stale()) {
+        auto [cost, current] = context.pop();
+
+        if (backward && stalled(context, _up_offsets, _up_targets, _up_costs, current)) continue;
+        if (!backward && stalled(context, _down_offsets, _down_sources, _down_costs, current)) continue;
+
+        visit(current, cost);
+
+        for (int e = offsets[current]; e < offsets[current + 1]; ++e) {
+            int next = nodes[e];
+
+            auto newcost = cost + costs[e];
+
+            if (!context.reached(next) || newcost < context.get_cost(next)) {
+                context.set_cost(next, newcost);
+                context.set_path(next, current);
+                context.push(next, newcost);
+            }
+        }
+    }
+}
+
+/**
+ * Fills table[i * targets.size() + j] with the distance from sources[i]
+ * to targets[j], infinite if there is no path.
+ *
+ * Bucket joins: the backward search space of every target leaves an entry
+ * (target, distance) in a bucket at each vertex it settles, and then the
+ * forward search of each source scans the buckets of the vertices it
+ * settles. Every shortest path meets at its highest vertex, so one upward
+ * search per source and per target covers the whole table. Both kinds of
+ * searches run in parallel, the forward ones each writing its own row.
+ */
+void ContractionHierarchy::distance_table(const std::vector<int>& sources,
+                                          const std::vector<int>& targets,
+                                          double* table, unsigned threads) const {
+    using entry_t = std::pair<int, double>;
+
+    std::size_t rows = sources.size(), columns = targets.size();
+    std::fill(table, table + rows * columns, inf);
+
+    std::vector<SearchContext> contexts(parallel_threads(threads), SearchContext(size()));
+
+    // Backward search spaces, as (vertex, distance) entries per target
+    std::vector<std::vector<entry_t>> spaces(columns);
+
+    parallel_blocks(columns, [&](std::size_t block, std::size_t begin, std::size_t end) {
+        for (std::size_t j = begin; j < end; ++j) {
+            upward(contexts[block], targets[j], true, [&](int v, double cost) {
+                spaces[j].push_back({v, cost});
+            });
+        }
+    }, threads, HIERARCHY_MIN_BLOCK);
+
+    // Buckets by vertex, as (column, distance) entries
+    std::vector<int> offsets(size() + 1, 0);
+    for (const auto& space : spaces) {
+        for (const entry_t& entry : space) ++offsets[entry.first + 1];
+    }
+    for (std::size_t v = 0; v < size(); ++v) offsets[v + 1] += offsets[v];
+
+    std::vector<entry_t> buckets(offsets.back());
+    std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+
+    for (std::size_t j = 0; j < columns; ++j) {
+        for (const entry_t& entry : spaces[j]) {
+            buckets[fill[entry.first]++] = {j, entry.second};
+        }
+    }
+
+    parallel_blocks(rows, [&](std::size_t block, std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            double* row = table + i * columns;
+
+            upward(contexts[block], sources[i], false, [&](int v, double cost) {
+                for (int b = offsets[v]; b < offsets[v + 1]; ++b) {
+                    double& cell = row[buckets[b].first];
+                    cell = std::min(cell, cost + buckets[b].second);
+                }
+            });
+        }
+    }, threads, HIERARCHY_MIN_BLOCK);
+}
+
+/**
+ * Middle vertex of the upward arc v->w.
+ */
+int ContractionHierarchy::up_middle(int v, int w) const {
+    for (int e = _up_offsets[v]; e < _up_offsets[v + 1]; ++e) {
+        if (_up_targets[e] == w) return _up_middles[e];
+    }
+    return -1;
+}
+
+/**
+ * Middle vertex of the downward arc u->v.
+ */
+int ContractionHierarchy::down_middle(int v, int u) const {
+    for (int e = _down_offsets[v]; e < _down_offsets[v + 1]; ++e) {
+        if (_down_sources[e] == u) return _down_middles[e];
+    }
+    return -1;
+}
+
+/**
+ * Appends the vertices after u on the arc u->w, shortcuts expanded. A
+ * shortcut u->w via m stands for the arcs u->m and m->w, which m kept as
+ * its downward and upward arcs when it was contracted.
+ */
+void ContractionHierarchy::unpack(int u, int w, int middle, path_t& path) const {
+    std::vector<std::tuple<int, int, int>> stack{{u, w, middle}};
+
+    while (!stack.empty()) {
+        auto [from, to, m] = stack.back();
+        stack.pop_back();
+
+        if (m == -1) {
+            path.push_back(_vertices[to]);
+        } else {
+            stack.push_back({m, to, up_middle(m, to)});
+            stack.push_back({from, m, down_middle(m, from)});
+        }
+    }
+}
+
+/**
+ * Path found by search(), with its shortcuts unpacked into the original
+ * vertices.
+ */
+path_t ContractionHierarchy::get_path(const SearchContext& forward, const SearchContext& backward,
+                                      int source, int target, int meet) const {
+    if (meet == -1) return path_t();
+
+    std::vector<int> climb;
+    for (int current = meet; current != source; current = forward.get_path(current)) {
+        climb.push_back(current);
+    }
+
+    path_t path{_vertices[source]};
+    int previous = source;
+
+    for (auto it = climb.rbegin(); it != climb.rend(); ++it) {
+        unpack(previous, *it, up_middle(previous, *it), path);
+        previous = *it;
+    }
+
+    for (int current = meet; current != target;) {
+        int next = backward.get_path(current);
+        unpack(current, next, down_middle(next, current), path);
+        current = next;
+    }
+
+    return path;
+}
@@ -0,0 +1,71 @@
+#ifndef HIERARCHY_H___
+#define HIERARCHY_H___
+
+#include "snapshot.h"
+#include "search_context.h"
+
+#include <vector>
+
+// A witness search gives up after settling this many vertices and the
+// shortcut is added anyway: a missed witness only costs a spare shortcut.
+#define HIERARCHY_WITNESS_LIMIT ((int)500)
+
+/**
+ * Contraction Hierarchies over the clear edges of a snapshot, by length.
+ *
+ * Preprocessing contracts the vertices in order of priority (edge
+ * difference plus deleted neighbours), adding a shortcut u->w via v
+ * whenever removing v could break the shortest path from u to w. Rounds
+ * contract an independent set of vertices, each the minimum of its
+ * neighbourhood, and their witness searches and the priority updates that
+ * follow run in parallel.
+ *
+ * Every vertex keeps its arcs to the vertices contracted after it: upward
+ * arcs leaving it, for the forward search, and downward arcs entering it,
+ * followed in reverse by the backward search. A query is a bidirectional
+ * Dijkstra over those arcs alone, and the path is recovered by unpacking
+ * each shortcut through its middle vertex.
+ *
+ * Built through Graph::hierarchy(), which rebuilds it lazily after the
+ * edge set changes. Traffic weights do not affect it.
+ */
+class ContractionHierarchy {
+private:
+    std::vector<int> _rank;
+
+    // Upward arcs v->w leaving v and downward arcs u->v entering v, to and
+    // from higher ranked vertices, each with the middle vertex it shortcuts
+    // (-1 for an original edge).
+    std::vector<int> _up_offsets, _up_targets, _up_middles;
+    std::vector<double> _up_costs;
+    std::vector<int> _down_offsets, _down_sources, _down_middles;
+    std::vector<double> _down_costs;
+
+    std::vector<Vertex*> _vertices;
+    std::size_t _shortcuts = 0;
+
+    int up_middle(int v, int w) const;
+    int down_middle(int v, int u) const;
+    void unpack(int u, int w, int middle, path_t& path) const;
+
+    template <typename Visit>
+    void upward(SearchContext& context, int source, bool backward, const Visit& visit) const;
+
+public:
+    explicit ContractionHierarchy(const Snapshot& snap, unsigned threads = 0);
+
+    std::size_t size() const;
+    std::size_t arcs() const;
+    std::size_t shortcuts() const;
+    int rank(int v) const;
+
+    int search(SearchContext& forward, SearchContext& backward, int source, int target) const;
+
+    path_t get_path(const SearchContext& forward, const SearchContext& backward,
+                    int source, int target, int meet) const;
+
+    void distance_table(const std::vector<int>& sources, const std::vector<int>& targets,
+                        double* table, unsigned threads = 0) const;
+};
+
+#endif // HIERARCHY_H___
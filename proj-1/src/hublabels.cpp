@@ -0,0 +1,271 @@
+#include "hublabels.h"
+#include "search_context.h"
+
+#include <algorithm>
+#include <limits>
+
+static constexpr double inf = std::numeric_limits<double>::infinity();
+
+namespace {
+
+struct Entry {
+    int hub;
+    double dist;
+    int via;
+};
+
+}
+
+HubLabels::HubLabels(const Snapshot& snap, const ContractionHierarchy& hierarchy, bool paths):
+    _paths(paths) {
+    int n = snap.size();
+
+    _vertices.resize(n);
+    for (int v = 0; v < n; ++v) _vertices[v] = snap.vertex(v);
+
+    // The last vertex contracted is the most important one.
+    _order.resize(n);
+    for (int v = 0; v < n; ++v) _order[n - 1 - hierarchy.rank(v)] = v;
+
+    std::vector<std::vector<Entry>> out(n), in(n);
+    std::vector<double> hub_dist(n, inf);
+    SearchContext context(n);
+
+    for (int hub = 0; hub < n; ++hub) {
+        int h = _order[hub];
+
+        // Forward from h, adding h to the in labels of the vertices it
+        // reaches by a path no earlier hub covers.
+        for (const Entry& entry : out[h]) hub_dist[entry.hub] = entry.dist;
+
+        context.reset(h);
+        context.push(h, 0);
+
+        while (context.skip_stale()) {
+            auto [dist, current] = context.pop();
+
+            bool covered = false;
+            for (const Entry& entry : in[current]) {
+                if (hub_dist[entry.hub] + entry.dist <= dist) {
+                    covered = true;
+                    break;
+                }
+            }
+            if (covered) continue;
+
+            in[current].push_back({hub, dist, context.get_path(current)});
+
+            for (int e = snap.begin(current); e < snap.end(current); ++e) {
+                int next = snap.target(e);
+
+                auto newcost = dist + snap.length(e);
+
+                if (!context.reached(next) || newcost < context.get_cost(next)) {
+                    context.set_cost(next, newcost);
+                    context.set_path(next, current);
+                    context.push(next, newcost);
+                }
+            }
+        }
+
+        for (const Entry& entry : out[h]) hub_dist[entry.hub] = inf;
+
+        // Backward to h, adding h to the out labels of the vertices that
+        // reach it by a path no earlier hub covers.
+        for (const Entry& entry : in[h]) hub_dist[entry.hub] = entry.dist;
+
+        context.reset(h);
+        context.push(h, 0);
+
+        while (context.skip_stale()) {
+            auto [dist, current] = context.pop();
+
+            bool covered = false;
+            for (const Entry& entry : out[current]) {
+                if (entry.dist + hub_dist[entry.hub] <= dist) {
+                    covered = true;
+                    break;
+                }
+            }
+            if (covered) continue;
+
+            out[current].push_back({hub, dist, context.get_path(current)});
+
+            for (int e = snap.in_begin(current); e < snap.in_end(current); ++e) {
+                int next = snap.in_source(e);
+
+                auto newcost = dist + snap.in_length(e);
+
+                if (!context.reached(next) || newcost < context.get_cost(next)) {
+                    context.set_cost(next, newcost);
+                    context.set_path(next, current);
+                    context.push(next, newcost);
+                }
+            }
+        }
+
+        for (const Entry& entry : in[h]) hub_dist[entry.hub] = inf;
+    }
+
+    // Flatten the labels into CSR arrays.
+    _out_offsets.reserve(n + 1);
+    _in_offsets.reserve(n + 1);
+    _out_offsets.push_back(0);
+    _in_offsets.push_back(0);
+
+    for (int v = 0; v < n; ++v) {
+        for (const Entry& entry : out[v]) {
+            _out_hubs.push_back(entry.hub);
+            _out_dists.push_back(entry.dist);
+            if (_paths) _out_next.push_back(entry.via);
+        }
+        for (const Entry& entry : in[v]) {
+            _in_hubs.push_back(entry.hub);
+            _in_dists.push_back(entry.dist);
+            if (_paths) _in_previous.push_back(entry.via);
+        }
+        _out_offsets.push_back(_out_hubs.size());
+        _in_offsets.push_back(_in_hubs.size());
+        std::vector<Entry>().swap(out[v]);
+        std::vector<Entry>().swap(in[v]);
+    }
+}
+
+std::size_t HubLabels::size() const {
+    return _vertices.size();
+}
+
+bool HubLabels::has_paths() const {
+    return _paths;
+}
+
+/**
+ * Position of the best hub of a path from source to target in the merged
+ * labels, -1 if there is no path.
+ */
+int HubLabels::hub(int source, int target) const {
+    int i = _out_offsets[source], i_end = _out_offsets[source + 1];
+    int j = _in_offsets[target], j_end = _in_offsets[target + 1];
+
+    double best = inf;
+    int hub = -1;
+
+    while (i < i_end && j < j_end) {
+        if (_out_hubs[i] < _in_hubs[j]) {
+            ++i;
+        } else if (_out_hubs[i] > _in_hubs[j]) {
+            ++j;
+        } else {
+            double dist = _out_dists[i] + _in_dists[j];
+            if (dist < best) {
+                best = dist;
+                hub = _out_hubs[i];
+            }
+            ++i, ++j;
+        }
+    }
+
+    return hub;
+}
+
+/**
+ * Length of the shortest path from source to target, infinite if there is
+ * none: the best common hub of the two labels.
+ */
+double HubLabels::distance(int source, int target) const {
+    int i = _out_offsets[source], i_end = _out_offsets[source + 1];
+    int j = _in_offsets[target], j_end = _in_offsets[target + 1];
+
+    double best = inf;
+
+    while (i < i_end && j < j_end) {
+        if (_out_hubs[i] < _in_hubs[j]) {
+            ++i;
+        } else if (_out_hubs[i] > _in_hubs[j]) {
+            ++j;
+        } else {
+            best = std::min(best, _out_dists[i] + _in_dists[j]);
+            ++i, ++j;
+        }
+    }
+
+    return best;
+}
+
+int HubLabels::out_entry(int v, int hub) const {
+    auto begin = _out_hubs.begin() + _out_offsets[v];
+    auto end = _out_hubs.begin() + _out_offsets[v + 1];
+    return std::lower_bound(begin, end, hub) - _out_hubs.begin();
+}
+
+int HubLabels::in_entry(int v, int hub) const {
+    auto begin = _in_hubs.begin() + _in_offsets[v];
+    auto end = _in_hubs.begin() + _in_offsets[v + 1];
+    return std::lower_bound(begin, end, hub) - _in_hubs.begin();
+}
+
+/**
+ * Shortest path from source to target, empty if there is none. Only with
+ * paths: every vertex on the way from source to the hub has the hub in its
+ * out label, and every vertex on the way from the hub to target has it in
+ * its in label, so the path is followed one entry lookup per hop.
+ */
+path_t HubLabels::get_path(int source, int target) const {
+    int hub = this->hub(source, target);
+    if (!_paths || hub == -1) return path_t();
+
+    int h = _order[hub];
+    path_t path{_vertices[source]};
+
+    for (int current = source; current != h;) {
+        current = _out_next[out_entry(current, hub)];
+        path.push_back(_vertices[current]);
+    }
+
+    path_t descent;
+    for (int current = target; current != h;) {
+        descent.push_back(_vertices[current]);
+        current = _in_previous[in_entry(current, hub)];
+    }
+
+    path.insert(path.end(), descent.rbegin(), descent.rend());
+    return path;
+}
+
+/**
+ * Number of label entries, in and out.
+ */
+std::size_t HubLabels::entries() const {
+    return _out_hubs.size() + _in_hubs.size();
+}
+
+/**
+ * Size of the largest label, in or out.
+ */
+std::size_t HubLabels::max_label() const {
+    std::size_t largest = 0;
+    for (std::size_t v = 0; v < size(); ++v) {
+        largest = std::max<std::size_t>(largest, _out_offsets[v + 1] - _out_offsets[v]);
+        largest = std::max<std::size_t>(largest, _in_offsets[v + 1] - _in_offsets[v]);
+    }
+    return largest;
+}
+
+/**
+ * Average size of a label, in or out.
+ */
+double HubLabels::average_label() const {
+    return size() == 0 ? 0 : double(entries()) / (2 * size());
+}
+
+/**
+ * Size of the labels, in bytes.
+ */
+std::size_t HubLabels::memory() const {
+    std::size_t bytes = 0;
+    bytes += (_out_offsets.size() + _out_hubs.size() + _out_next.size()) * sizeof(int);
+    bytes += (_in_offsets.size() + _in_hubs.size() + _in_previous.size()) * sizeof(int);
+    bytes += (_out_dists.size() + _in_dists.size()) * sizeof(double);
+    bytes += _order.size() * sizeof(int);
+    return bytes;
+}
@@ -0,0 +1,62 @@
+#ifndef HUBLABELS_H___
+#define HUBLABELS_H___
+
+#include "snapshot.h"
+#include "hierarchy.h"
+
+#include <vector>
+
+/**
+ * Hub labeling distance oracle over the clear edges of a snapshot, by
+ * length.
+ *
+ * Every vertex v gets an out label, hubs h with d(v, h), and an in label,
+ * hubs h with d(h, v), such that some shortest path from s to t always
+ * passes through a hub in both the out label of s and the in label of t.
+ * A distance query is then a merge of two sorted labels, with no search.
+ *
+ * The labels are built by pruned landmark labeling: a forward and a
+ * backward Dijkstra from every vertex in order of importance, the
+ * contraction hierarchy's order from the top down, each of them pruned
+ * wherever the labels so far already give the distance. Hubs are stored as
+ * positions in that order, so the labels come out sorted.
+ *
+ * With paths, each label entry also keeps the next vertex towards (or the
+ * previous vertex from) its hub, enough to recover the whole path hop by
+ * hop. Without, the labels take a third less memory.
+ */
+class HubLabels {
+private:
+    // Out and in labels of every vertex, CSR: hub positions and distances,
+    // and with paths the successor (out) or predecessor (in) vertex.
+    std::vector<int> _out_offsets, _out_hubs, _out_next;
+    std::vector<double> _out_dists;
+    std::vector<int> _in_offsets, _in_hubs, _in_previous;
+    std::vector<double> _in_dists;
+
+    // Vertex at each position of the order
+    std::vector<int> _order;
+    std::vector<Vertex*> _vertices;
+    bool _paths;
+
+    int out_entry(int v, int hub) const;
+    int in_entry(int v, int hub) const;
+
+public:
+    HubLabels(const Snapshot& snap, const ContractionHierarchy& hierarchy, bool paths = false);
+
+    std::size_t size() const;
+    bool has_paths() const;
+
+    double distance(int source, int target) const;
+    int hub(int source, int target) const;
+    path_t get_path(int source, int target) const;
+
+    // Statistics
+    std::size_t entries() const;
+    std::size_t max_label() const;
+    double average_label() const;
+    std::size_t memory() const;
+};
+
+#endif // HUBLABELS_H___
@@ -0,0 +1,113 @@
+#ifndef IDMAP_H___
+#define IDMAP_H___
+
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Id-keyed storage for the vertices, edges and roads of a Graph.
+ *
+ * The loader hands out contiguous ids starting at 1, so ids are normally
+ * looked up in a plain vector indexed by id. Ids that are negative or far
+ * beyond the number of stored items go to a sparse hash map instead, so
+ * arbitrary ids still work without blowing up the vector.
+ *
+ * The items are also kept contiguously in insertion order: iterating an
+ * IdMap is a sequential sweep, and an item's position in that order is its
+ * storage index.
+ */
+template <typename T>
+class IdMap {
+private:
+    std::vector<T*> _items;
+    std::vector<T*> _dense;
+    std::unordered_map<int, T*> _sparse;
+
+    bool fits_dense(int id) const;
+
+public:
+    using const_iterator = typename std::vector<T*>::const_iterator;
+
+    T* get(int id) const;
+    bool insert(int id, T* item);
+    void reserve(std::size_t n);
+
+    std::size_t size() const;
+    bool empty() const;
+    T* operator[](std::size_t index) const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+};
+
+template <typename T>
+bool IdMap<T>::fits_dense(int id) const {
+    return id >= 0 && static_cast<std::size_t>(id) <= 2 * _items.size() + 1024;
+}
+
+template <typename T>
+T* IdMap<T>::get(int id) const {
+    if (id >= 0 && static_cast<std::size_t>(id) < _dense.size() && _dense[id] != nullptr) {
+        return _dense[id];
+    }
+
+    if (_sparse.empty()) return nullptr;
+
+    auto it = _sparse.find(id);
+
+    if (it == _sparse.end()) {
+        return nullptr;
+    } else {
+        return it->second;
+    }
+}
+
+template <typename T>
+bool IdMap<T>::insert(int id, T* item) {
+    if (get(id) != nullptr) return false;
+
+    if (fits_dense(id)) {
+        if (static_cast<std::size_t>(id) >= _dense.size()) {
+            _dense.resize(id + 1, nullptr);
+        }
+        _dense[id] = item;
+    } else {
+        _sparse[id] = item;
+    }
+
+    _items.push_back(item);
+    return true;
+}
+
+template <typename T>
+void IdMap<T>::reserve(std::size_t n) {
+    _items.reserve(n);
+    _dense.reserve(n + 1);
+}
+
+template <typename T>
+std::size_t IdMap<T>::size() const {
+    return _items.size();
+}
+
+template <typename T>
+bool IdMap<T>::empty() const {
+    return _items.empty();
+}
+
+template <typename T>
+T* IdMap<T>::operator[](std::size_t index) const {
+    return _items[index];
+}
+
+template <typename T>
+typename IdMap<T>::const_iterator IdMap<T>::begin() const {
+    return _items.begin();
+}
+
+template <typename T>
+typename IdMap<T>::const_iterator IdMap<T>::end() const {
+    return _items.end();
+}
+
+#endif // IDMAP_H___
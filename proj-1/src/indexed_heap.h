@@ -0,0 +1,128 @@
+#ifndef INDEXED_HEAP_H___
+#define INDEXED_HEAP_H___
+
+#include "MutablePriorityQueue.h"
+
+#include <cassert>
+#include <utility>
+#include <vector>
+
+/**
+ * Indexed d-ary min-heap of integer ids 0..size()-1 with decrease-key.
+ *
+ * Unlike the heaps in MutablePriorityQueue.h, the position of every id is
+ * kept in the heap's own array, not in the element. Nothing is written to
+ * the graph, so any number of heaps can hold the same vertices at once: both
+ * sides of a bidirectional search, or one heap per thread. Like DaryHeap the
+ * keys sit inline next to the ids, and the heap is 1-indexed so position 0
+ * means the id is not in the heap.
+ *
+ * clear() only resets the positions of the ids still queued, so a heap is
+ * reused across queries at the cost of what each query pushed.
+ */
+template <unsigned Arity = MUTABLE_QUEUE_ARITY>
+class IndexedHeap {
+    static_assert(Arity >= 2, "a heap needs at least two children per node");
+
+public:
+    using entry_t = std::pair<double, int>;
+
+private:
+    struct Node {
+        double key;
+        int id;
+    };
+
+    std::vector<Node> _heap;
+    std::vector<unsigned> _position;
+
+    static unsigned parent(unsigned i) { return (i - 2) / Arity + 1; }
+    static unsigned first_child(unsigned i) { return (i - 1) * Arity + 2; }
+
+    void set(unsigned i, Node node) {
+        _heap[i] = node;
+        _position[node.id] = i;
+    }
+
+    void sift_up(unsigned i, Node node) {
+        while (i > 1 && node.key < _heap[parent(i)].key) {
+            set(i, _heap[parent(i)]);
+            i = parent(i);
+        }
+        set(i, node);
+    }
+
+    void sift_down(unsigned i, Node node) {
+        unsigned size = _heap.size();
+        while (true) {
+            unsigned k = first_child(i);
+            if (k >= size) break;
+
+            unsigned end = k + Arity < size ? k + Arity : size;
+            unsigned best = k;
+            for (++k; k < end; ++k) {
+                if (_heap[k].key < _heap[best].key) best = k;
+            }
+
+            if (!(_heap[best].key < node.key)) break;
+            set(i, _heap[best]);
+            i = best;
+        }
+        set(i, node);
+    }
+
+public:
+    explicit IndexedHeap(std::size_t size): _heap(1), _position(size, 0) {}
+
+    std::size_t size() const {
+        return _position.size();
+    }
+
+    bool empty() const {
+        return _heap.size() == 1;
+    }
+
+    bool contains(int id) const {
+        return _position[id] != 0;
+    }
+
+    double key(int id) const {
+        assert(contains(id));
+        return _heap[_position[id]].key;
+    }
+
+    entry_t top() const {
+        return {_heap[1].key, _heap[1].id};
+    }
+
+    /**
+     * Inserts id with key, or lowers its key if it is already queued.
+     */
+    void push(int id, double key) {
+        if (contains(id)) {
+            assert(key <= this->key(id));
+            sift_up(_position[id], {key, id});
+        } else {
+            _heap.push_back({key, id});
+            sift_up(_heap.size() - 1, _heap.back());
+        }
+    }
+
+    entry_t pop() {
+        Node node = _heap[1];
+        _position[node.id] = 0;
+
+        Node last = _heap.back();
+        _heap.pop_back();
+        if (!empty()) sift_down(1, last);
+
+        return {node.key, node.id};
+    }
+
+    void clear() {
+        for (unsigned i = 1; i < _heap.size(); ++i) _position[_heap[i].id] = 0;
+        _heap.resize(1);
+    }
+};
+
+#endif // INDEXED_HEAP_H___
@@ -0,0 +1,291 @@
+#include "landmarks.h"
+#include "parallel.h"
+
+#include <cfloat>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
+
+static constexpr double inf = std::numeric_limits<double>::infinity();
+
+// Candidate roots tried when looking for the main part of the map
+#define LANDMARKS_ROOT_SAMPLES ((int)8)
+
+/**
+ * Full Dijkstra from sources over the outgoing edges, or over the incoming
+ * edges if backward, by length or weight, optionally only through the
+ * vertices marked in core. Optionally records the shortest path tree and
+ * the order the vertices were settled in.
+ */
+static void shortest_paths(const Snapshot& snap, Landmarks::metric measure, bool backward,
+                           const std::vector<int>& sources, std::vector<double>& dist,
+                           const std::vector<char>* core = nullptr,
+                           std::vector<int>* parent = nullptr, std::vector<int>* order = nullptr) {
+    using entry_t = std::pair<double, int>;
+    std::vector<entry_t> queue;
+
+    dist.assign(snap.size(), inf);
+    if (parent) parent->assign(snap.size(), -1);
+    if (order) order->clear();
+
+    for (int source : sources) {
+        dist[source] = 0;
+        if (parent) (*parent)[source] = source;
+        queue.push_back({0, source});
+    }
+    std::make_heap(queue.begin(), queue.end(), std::greater<entry_t>());
+
+    bool length = measure == Landmarks::metric::length;
+
+    while (!queue.empty()) {
+        std::pop_heap(queue.begin(), queue.end(), std::greater<entry_t>());
+        auto [cost, current] = queue.back();
+        queue.pop_back();
+
+        if (cost > dist[current]) continue;
+        if (order) order->push_back(current);
+
+        int begin = backward ? snap.in_begin(current) : snap.begin(current);
+        int end = backward ? snap.in_end(current) : snap.end(current);
+
+        for (int e = begin; e < end; ++e) {
+            int next;
+            double newcost = cost;
+
+            if (backward) {
+                next = snap.in_source(e);
+                newcost += length ? snap.in_length(e) : snap.in_weight(e);
+            } else {
+                next = snap.target(e);
+                newcost += length ? snap.length(e) : snap.weight(e);
+            }
+
+            if (core && !(*core)[next]) continue;
+
+            if (newcost < dist[next]) {
+                dist[next] = newcost;
+                if (parent) (*parent)[next] = current;
+                queue.push_back({newcost, next});
+                std::push_heap(queue.begin(), queue.end(), std::greater<entry_t>());
+            }
+        }
+    }
+}
+
+static std::uint64_t splitmix64(std::uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+Landmarks::Landmarks(const Snapshot& snap, int count, selection strategy, metric measure,
+                     unsigned threads):
+    _metric(measure), _count(count) {
+    int n = snap.size();
+
+    // Landmarks are picked inside the largest strongly connected part of the
+    // map found around a few sampled vertices. A landmark in a dead end, as
+    // the farthest vertices of a one-way street map tend to be, bounds
+    // nothing and leads the selection nowhere.
+    int root = 0;
+    std::size_t largest = 0;
+    std::vector<char> core;
+    std::vector<double> forward, backward;
+
+    for (int i = 0; i < LANDMARKS_ROOT_SAMPLES && n > 0; ++i) {
+        int v = std::size_t(n) * i / LANDMARKS_ROOT_SAMPLES;
+        shortest_paths(snap, _metric, false, {v}, forward);
+        shortest_paths(snap, _metric, true, {v}, backward);
+
+        std::vector<char> component(n);
+        std::size_t size = 0;
+        for (int u = 0; u < n; ++u) {
+            component[u] = forward[u] != inf && backward[u] != inf;
+            size += component[u];
+        }
+
+        if (size > largest) {
+            root = v;
+            largest = size;
+            core = std::move(component);
+        }
+    }
+
+    _to.assign(std::size_t(n) * _count, 0);
+    _from.assign(std::size_t(n) * _count, 0);
+
+    if (n > 0) {
+        if (strategy == selection::farthest) {
+            select_farthest(snap, core, root, threads);
+        } else {
+            select_avoid(snap, core, root, threads);
+        }
+    }
+
+    // Selection can run out of distinct landmarks on tiny maps.
+    int selected = _landmarks.size();
+    if (selected < _count) {
+        for (int v = 0; v < n; ++v) {
+            for (int i = 0; i < selected; ++i) {
+                _to[std::size_t(v) * selected + i] = _to[std::size_t(v) * _count + i];
+                _from[std::size_t(v) * selected + i] = _from[std::size_t(v) * _count + i];
+            }
+        }
+        _to.resize(std::size_t(n) * selected);
+        _from.resize(std::size_t(n) * selected);
+        _count = selected;
+    }
+
+    float furthest = 0;
+    for (std::size_t i = 0; i < _to.size(); ++i) {
+        if (_to[i] != LANDMARKS_UNREACHABLE) furthest = std::max(furthest, _to[i]);
+        if (_from[i] != LANDMARKS_UNREACHABLE) furthest = std::max(furthest, _from[i]);
+    }
+    _slack = 2 * FLT_EPSILON * furthest;
+}
+
+/**
+ * Fills the table columns of landmarks first..last-1, one full Dijkstra
+ * per landmark and direction, spread over the threads. That is only two
+ * tasks when select_avoid() adds a single landmark.
+ */
+void Landmarks::compute(const Snapshot& snap, int first, int last, unsigned threads) {
+    std::size_t tasks = 2 * (last - first);
+    std::vector<std::vector<double>> dist(parallel_threads(threads));
+
+    parallel_blocks(tasks, [&](std::size_t block, std::size_t begin, std::size_t end) {
+        for (std::size_t task = begin; task < end; ++task) {
+            int i = first + task / 2;
+            bool backward = task % 2 == 1;
+            std::vector<float>& table = backward ? _to : _from;
+
+            shortest_paths(snap, _metric, backward, {_landmarks[i]}, dist[block]);
+
+            for (std::size_t v = 0; v < snap.size(); ++v) {
+                double d = dist[block][v];
+                table[v * _count + i] = d == inf ? LANDMARKS_UNREACHABLE : float(d);
+            }
+        }
+    }, threads, 1);
+}
+
+/**
+ * The first landmark is the vertex farthest from root, and every next one
+ * the vertex farthest from all the landmarks so far.
+ */
+void Landmarks::select_farthest(const Snapshot& snap, const std::vector<char>& core, int root,
+                                unsigned threads) {
+    std::vector<int> sources{root};
+    std::vector<double> dist;
+
+    while ((int)_landmarks.size() < _count) {
+        shortest_paths(snap, _metric, false, sources, dist, &core);
+
+        int farthest = -1;
+        for (int v = 0; v < (int)snap.size(); ++v) {
+            if (dist[v] == inf || dist[v] == 0) continue;
+            if (farthest == -1 || dist[v] > dist[farthest]) farthest = v;
+        }
+
+        if (farthest == -1) break;
+        _landmarks.push_back(farthest);
+        sources = _landmarks;
+    }
+
+    compute(snap, 0, _landmarks.size(), threads);
+}
+
+/**
+ * Each step grows a shortest path tree from a random vertex of the core
+ * and weighs every vertex v by how badly the landmarks so far bound
+ * its distance from the tree root. A subtree scores the total weight of
+ * its vertices, or zero if it holds a landmark already. The new landmark
+ * is the leaf reached by descending from the best scoring vertex through
+ * the best scoring children.
+ */
+void Landmarks::select_avoid(const Snapshot& snap, const std::vector<char>& core, int root,
+                             unsigned threads) {
+    int n = snap.size();
+    std::vector<double> dist;
+    std::vector<int> parent, order;
+
+    std::vector<int> candidates;
+    for (int v = 0; v < n; ++v) {
+        if (core[v]) candidates.push_back(v);
+    }
+
+    std::vector<char> landmark(n, 0), covered(n);
+    std::vector<double> size(n);
+    std::vector<int> child_offsets(n + 1), children(n);
+
+    while ((int)_landmarks.size() < _count) {
+        int r = candidates[splitmix64(_landmarks.size()) % candidates.size()];
+        shortest_paths(snap, _metric, false, {r}, dist, &core, &parent, &order);
+
+        std::fill(size.begin(), size.end(), 0);
+        std::fill(covered.begin(), covered.end(), 0);
+
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            int v = *it, p = parent[v];
+            double total = size[v] + dist[v] - bound(r, v);
+
+            if (covered[v] || landmark[v]) {
+                total = 0;
+                covered[p] = 1;
+            }
+            size[v] = total;
+            if (p != v) size[p] += total;
+        }
+
+        // Children of every vertex in the tree, for the descent
+        std::fill(child_offsets.begin(), child_offsets.end(), 0);
+        for (int v : order) {
+            if (parent[v] != v) ++child_offsets[parent[v] + 1];
+        }
+        for (int v = 0; v < n; ++v) child_offsets[v + 1] += child_offsets[v];
+
+        std::vector<int> fill(child_offsets.begin(), child_offsets.end() - 1);
+        for (int v : order) {
+            if (parent[v] != v) children[fill[parent[v]]++] = v;
+        }
+
+        int best = -1;
+        for (int v : order) {
+            if (size[v] > 0 && (best == -1 || size[v] > size[best])) best = v;
+        }
+        if (best == -1) break;
+
+        while (child_offsets[best] < child_offsets[best + 1]) {
+            int next = children[child_offsets[best]];
+            for (int i = child_offsets[best]; i < child_offsets[best + 1]; ++i) {
+                if (size[children[i]] > size[next]) next = children[i];
+            }
+            best = next;
+        }
+
+        landmark[best] = 1;
+        _landmarks.push_back(best);
+        compute(snap, _landmarks.size() - 1, _landmarks.size(), threads);
+    }
+}
+
+Landmarks::metric Landmarks::measure() const {
+    return _metric;
+}
+
+std::size_t Landmarks::count() const {
+    return _count;
+}
+
+const std::vector<int>& Landmarks::landmarks() const {
+    return _landmarks;
+}
+
+/**
+ * Size of the distance tables, in bytes.
+ */
+std::size_t Landmarks::memory() const {
+    return (_to.size() + _from.size()) * sizeof(float);
+}
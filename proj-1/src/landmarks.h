@@ -0,0 +1,98 @@
+#ifndef LANDMARKS_H___
+#define LANDMARKS_H___
+
+#include "snapshot.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#define LANDMARKS_DEFAULT_COUNT ((int)16)
+
+// Distance stored for a vertex that cannot reach (or be reached from) a
+// landmark. Finite, so differences of two of them are 0 and never NaN.
+#define LANDMARKS_UNREACHABLE 1e30f
+
+/**
+ * Landmark distance tables for A* with the ALT heuristic (A*, Landmarks,
+ * Triangle inequality), over the clear edges of a snapshot by length or by
+ * weight.
+ *
+ * For every landmark L, the triangle inequality gives the lower bounds
+ * d(v, t) >= d(v, L) - d(t, L) and d(v, t) >= d(L, t) - d(L, v). The best
+ * of them over a few well spread landmarks is much tighter than the
+ * straight line distance, and it works for weights too, which have no
+ * geometric bound at all.
+ *
+ * Landmarks are picked by one of two strategies:
+ *   farthest: each landmark is the vertex farthest from the ones so far.
+ *   avoid: each landmark is the leaf of the region of a shortest path tree
+ *          whose distances the current landmarks bound worst (Goldberg and
+ *          Werneck), which usually gives better bounds for the same count.
+ *
+ * The distances to and from every landmark are computed in parallel and
+ * stored as floats, vertex-major, so that the bound for a vertex reads
+ * its own contiguous row. farthest computes all the tables at once, once
+ * the landmarks are picked. avoid needs the tables of the landmarks so far
+ * to pick the next one, so it computes the two tables of each landmark as
+ * soon as it is picked, and runs at most two Dijkstras at a time. Rounding to float is covered by a small slack
+ * taken off every bound, which keeps it admissible.
+ *
+ * Distances by weight are only valid for the weights they were computed
+ * from; rebuild the tables after the traffic changes.
+ */
+class Landmarks {
+public:
+    enum class selection : char { farthest, avoid };
+    enum class metric : char { length, weight };
+
+private:
+    const metric _metric;
+    int _count;
+    std::vector<int> _landmarks;
+
+    // d(v, L) and d(L, v) for landmark L = _landmarks[i] at [v * count + i]
+    std::vector<float> _to, _from;
+
+    // Worst float rounding error of a difference of two table entries
+    double _slack = 0;
+
+    void compute(const Snapshot& snap, int first, int last, unsigned threads);
+    void select_farthest(const Snapshot& snap, const std::vector<char>& core, int root,
+                         unsigned threads);
+    void select_avoid(const Snapshot& snap, const std::vector<char>& core, int root,
+                      unsigned threads);
+
+public:
+    explicit Landmarks(const Snapshot& snap, int count = LANDMARKS_DEFAULT_COUNT,
+                       selection strategy = selection::avoid,
+                       metric measure = metric::length, unsigned threads = 0);
+
+    metric measure() const;
+    std::size_t count() const;
+    const std::vector<int>& landmarks() const;
+    std::size_t memory() const;
+
+    double bound(int v, int target) const;
+};
+
+/**
+ * Lower bound on the distance from v to target, infinite if some landmark
+ * proves that v cannot reach target. Hot, inlined.
+ */
+inline double Landmarks::bound(int v, int target) const {
+    const float* to_v = &_to[std::size_t(v) * _count];
+    const float* to_t = &_to[std::size_t(target) * _count];
+    const float* from_v = &_from[std::size_t(v) * _count];
+    const float* from_t = &_from[std::size_t(target) * _count];
+
+    double best = 0;
+    for (int i = 0; i < _count; ++i) {
+        best = std::max(best, double(to_v[i]) - to_t[i]);
+        best = std::max(best, double(from_t[i]) - from_v[i]);
+    }
+    if (best >= LANDMARKS_UNREACHABLE / 2) return std::numeric_limits<double>::infinity();
+    return std::max(0.0, best - _slack);
+}
+
+#endif // LANDMARKS_H___
@@ -9,9 +9,17 @@
 #include <iostream>
 #include <sstream>
 #include <unordered_map>
+#include <algorithm>
+#include <vector>
 
 #define DEBUG_LOADMAP 1
 
+// Number vertices along a Hilbert curve over (x, y), and edges by source,
+// so that nearby vertices and their edges sit close together in memory.
+#ifndef LOADMAP_HILBERT_ORDER
+#define LOADMAP_HILBERT_ORDER 1
+#endif
+
 static std::unordered_map<long long, int> vertex_id_map;
 static std::unordered_map<long long, int> road_id_map;
 
@@ -30,6 +38,15 @@ static bool string_to_bool(std::string match) {
     return static_cast<bool>(std::stoi(match));
 }
 
+/**
+ * std::getline that also drops the '\r' of files with Windows line endings,
+ * so the map files load the same on every platform.
+ */
+static void read_line(std::ifstream& file, std::string& line) {
+    std::getline(file, line);
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+}
+
 static int computeX(double longitude, const metadata& meta) {
     double long_delta = meta.max_longitude - meta.min_longitude;
     return std::floor(meta.width * (longitude - meta.min_longitude) / long_delta);
@@ -40,6 +57,32 @@ static int computeY(double latitude, const metadata& meta) {
     return std::floor(meta.height * (meta.max_latitude - latitude) / lat_delta);
 }
 
+/**
+ * Position of (x, y) along the Hilbert curve filling the square of side
+ * 2^order.
+ */
+static long long hilbert_key(int x, int y, int order) {
+    int n = 1 << order;
+    long long key = 0;
+
+    for (int s = n / 2; s > 0; s /= 2) {
+        int rx = (x & s) > 0;
+        int ry = (y & s) > 0;
+        key += (long long)s * s * ((3 * rx) ^ ry);
+
+        // Rotate the quadrant so the curve stays continuous.
+        if (ry == 0) {
+            if (rx == 1) {
+                x = n - 1 - x;
+                y = n - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+
+    return key;
+}
+
 static double deg_to_rad(double degrees) {
     static const double pi = std::acos(-1);
     return degrees * pi / 180.0;
@@ -257,6 +300,13 @@ static int load_meta(std::string filename, metadata &meta) {
     return 0;
 }
 
+struct node_line {
+    long long file_id;
+    double latitude, longitude;
+    int x, y;
+    int line_number;
+};
+
 static int load_nodes(const std::string& filename, const metadata &meta) {
     static const std::regex reg(R"Z(^(\d+);(-?\d+(?:\.\d+)?);(-?\d+(?:\.\d+)?);(?:-?\d+(?:\.\d+)?);(?:-?\d+(?:\.\d+)?);?$)Z");
 
@@ -265,20 +315,20 @@ static int load_nodes(const std::string& filename, const metadata &meta) {
         return 1;
 
     std::string line;
-    std::getline(file, line);
+    read_line(file, line);
 
     int line_number = 1, count = 1;
+    std::vector<node_line> nodes;
+    nodes.reserve(meta.nodes);
 
     while (!file.eof() && !file.fail()) {
         std::smatch match;
-        double latitude, longitude;
+        double latitude = 0, longitude = 0;
 
         if (std::regex_match(line, match, reg)) {
             try {
                 // Get Node ID
                 long long file_id = std::stoll(match[1]);
-                int id = count++;
-                vertex_id_map[file_id] = id;
 
                 // Get Node Latitude
                 latitude = std::stod(match[2]);
@@ -288,11 +338,7 @@ static int load_nodes(const std::string& filename, const metadata &meta) {
                 longitude = std::stod(match[3]);
                 int x = computeX(longitude, meta);
 
-                // Add Node
-                Vertex* vertex = new Vertex(id, x, y);
-                bool success = graph->add_vertex(vertex);
-
-                if (!success) throw std::out_of_range("Vertex coordinates out of bounds");
+                nodes.push_back({file_id, latitude, longitude, x, y, line_number});
                 // Done
             } catch (std::exception &e) {
                 std::cerr << "Error on file " << filename << std::endl;
@@ -307,10 +353,46 @@ static int load_nodes(const std::string& filename, const metadata &meta) {
         }
 
         ++line_number;
-        std::getline(file, line);
+        read_line(file, line);
     }
 
     file.close();
+
+    if (LOADMAP_HILBERT_ORDER) {
+        int order = 1;
+        while ((1 << order) <= std::max(meta.width, meta.height)) ++order;
+
+        std::vector<std::pair<long long, int>> keys(nodes.size());
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            keys[i] = {hilbert_key(nodes[i].x, nodes[i].y, order), i};
+        }
+        std::sort(keys.begin(), keys.end());
+
+        std::vector<node_line> sorted(nodes.size());
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            sorted[i] = nodes[keys[i].second];
+        }
+        nodes.swap(sorted);
+    }
+
+    for (const node_line& node : nodes) {
+        int id = count++;
+        vertex_id_map[node.file_id] = id;
+
+        // Add Node
+        Vertex* vertex = graph->make_vertex(id, node.x, node.y);
+        bool success = graph->add_vertex(vertex);
+
+        if (!success) {
+            std::cerr << "Error on file " << filename << std::endl;
+            std::cerr << "Line: " << node.line_number << std::endl;
+            std::cerr << "Vertex coordinates out of bounds" << std::endl;
+            std::cerr << "Vertex Latitude = " << node.latitude << std::endl;
+            std::cerr << "Vertex Longitude = " << node.longitude << std::endl;
+            return 2;
+        }
+    }
+
     return 0;
 }
 
@@ -321,7 +403,7 @@ static int load_roads(const std::string& filename, const metadata &meta) {
     if (!file.is_open()) return 1;
 
     std::string line;
-    std::getline(file, line);
+    read_line(file, line);
 
     int line_number = 1, count = 1;
 
@@ -349,7 +431,7 @@ static int load_roads(const std::string& filename, const metadata &meta) {
                 }
 
                 // Register Road
-                Road* road = new Road(id, name, bothways);
+                Road* road = graph->make_road(id, name, bothways);
                 graph->add_road(road);
                 // Done
             } catch (std::exception &e) {
@@ -361,13 +443,20 @@ static int load_roads(const std::string& filename, const metadata &meta) {
         }
 
         ++line_number;
-        std::getline(file, line);
+        read_line(file, line);
     }
 
     file.close();
     return 0;
 }
 
+struct edge_line {
+    Vertex* source;
+    Vertex* target;
+    Road* road;
+    bool forward;
+};
+
 static int load_edges(const std::string& filename, const metadata &meta) {
     static const std::regex reg(R"Z(^(\d+);(\d+);(\d+);?$)Z");
 
@@ -375,9 +464,10 @@ static int load_edges(const std::string& filename, const metadata &meta) {
     if (!file.is_open()) return 1;
 
     std::string line;
-    std::getline(file, line);
+    read_line(file, line);
 
     int line_number = 1, count = 1;
+    std::vector<edge_line> edges;
 
     while (!file.eof() && !file.fail()) {
         std::smatch match;
@@ -416,14 +506,10 @@ static int load_edges(const std::string& filename, const metadata &meta) {
                 Road* road = graph->get_road(roadid);
 
                 // Load edge
-                Edge* edge = new Edge(count++, source, target, road);
-                graph->add_edge(edge);
-                road->add_edge(edge, true);
+                edges.push_back({source, target, road, true});
 
                 if (road->bothways()) {
-                    edge = new Edge(count++, target, source, road);
-                    graph->add_edge(edge);
-                    road->add_edge(edge, false);
+                    edges.push_back({target, source, road, false});
                 }
                 // Done
             } catch (std::exception &e) {
@@ -435,14 +521,37 @@ static int load_edges(const std::string& filename, const metadata &meta) {
         }
 
         ++line_number;
-        std::getline(file, line);
+        read_line(file, line);
     }
 
     file.close();
+
+    // Creation order: by source vertex, if reordering, otherwise file order.
+    std::vector<int> order(edges.size());
+    for (std::size_t i = 0; i < edges.size(); ++i) order[i] = i;
+
+    if (LOADMAP_HILBERT_ORDER) {
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+            return edges[a].source->index() < edges[b].source->index();
+        });
+    }
+
+    std::vector<Edge*> created(edges.size());
+    for (int i : order) {
+        const edge_line& e = edges[i];
+        created[i] = graph->make_edge(count++, e.source, e.target, e.road);
+        graph->add_edge(created[i]);
+    }
+
+    // Roads list their edges in file order.
+    for (std::size_t i = 0; i < edges.size(); ++i) {
+        edges[i].road->add_edge(created[i], edges[i].forward);
+    }
+
     return 0;
 }
 
-int load_map(std::string filename) {
+int load_map(std::string filename, bool headless) {
     if (!check_filename(filename)) {
         return 1;
     }
@@ -452,7 +561,10 @@ int load_map(std::string filename) {
         return 1;
     }
 
-    graph = std::make_unique<Graph>(meta.width, meta.height, meta.scale);
+    graph = std::make_unique<Graph>(meta.width, meta.height, meta.scale, headless);
+
+    // Edges are doubled for two-way roads.
+    graph->reserve(meta.nodes, meta.oneway ? meta.edges : 2 * meta.edges);
 
     if (meta.boundaries) graph->show_boundaries();
 
@@ -472,6 +584,9 @@ int load_map(std::string filename) {
         return 1;
     }
 
+    graph->spatial();
+    graph->reachability();
+
     graph->update();
     return 0;
 }
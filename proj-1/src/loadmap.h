@@ -26,6 +26,6 @@ struct metadata {
 
 bool check_filename(std::string filename);
 
-int load_map(std::string filename);
+int load_map(std::string filename, bool headless = false);
 
 #endif // LOADMAP_H___
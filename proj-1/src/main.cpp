@@ -8,6 +8,7 @@
 #include <string>
 
 #include "test_search.h"
+#include "test_paths.h"
 
 #define FILENAME_PREFIX "./resource/"
 
@@ -45,18 +46,44 @@ static void get_filename(std::string& filename) {
     }
 }
 
+/**
+ * Usage: cal.exe [--headless] [--test] [map]
+ *   --headless  Do not start the GraphViewer (batch routing and benchmarks)
+ *   --test      Check every search on the map against Dijkstra and exit,
+ *               nonzero if any check fails
+ *   map         Map to load (e.g. porto), asked for if missing or not found
+ */
 int main(int argc, char* argv[]) {
     //return test();
 
     std::srand((unsigned)std::time(nullptr));
     std::ios::sync_with_stdio(false);
 
+    bool headless = false;
+    bool testing = false;
     std::string filename;
-    get_filename(filename);
 
-    if (load_map(filename) != 0) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "--headless") {
+            headless = true;
+        } else if (arg == "--test") {
+            testing = true;
+        } else {
+            filename = FILENAME_PREFIX + arg;
+        }
+    }
+
+    if (filename.empty() || !check_filename(filename)) {
+        get_filename(filename);
+    }
+
+    if (load_map(filename, headless) != 0) {
         ui::discard();
         return 1;
+    } else if (testing) {
+        return test_paths() == 0 ? 0 : 1;
     } else {
         ui::main_menu();
     }
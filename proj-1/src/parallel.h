@@ -0,0 +1,61 @@
+#ifndef PARALLEL_H___
+#define PARALLEL_H___
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Below this many items a loop is not worth spreading over threads
+#define PARALLEL_MIN_BLOCK ((std::size_t)4096)
+
+/**
+ * Number of worker threads to use when the caller does not ask for a
+ * specific count: one per hardware thread.
+ */
+inline unsigned parallel_threads(unsigned threads = 0) {
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    return std::max(threads, 1u);
+}
+
+/**
+ * Splits [0, n) into at most one contiguous block per thread (threads = 0
+ * uses every core) and calls body(block, begin, end) once for each, so the
+ * body can keep per-block scratch state, indexed by block, across the items
+ * of its block. Blocks are numbered below parallel_threads(threads).
+ */
+template <typename Body>
+void parallel_blocks(std::size_t n, const Body& body, unsigned threads = 0,
+                     std::size_t min_block = PARALLEL_MIN_BLOCK) {
+    std::size_t blocks = std::min<std::size_t>(parallel_threads(threads),
+                                               n / min_block + 1);
+
+    auto run = [&](std::size_t block) {
+        body(block, n * block / blocks, n * (block + 1) / blocks);
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(blocks - 1);
+
+    for (std::size_t block = 1; block < blocks; ++block) {
+        workers.emplace_back(run, block);
+    }
+    run(0);
+
+    for (std::thread& worker : workers) worker.join();
+}
+
+/**
+ * Calls body(i) for every i in [0, n), splitting the range into one
+ * contiguous block per thread (threads = 0 uses every core). body(i) must
+ * only write state owned by index i; then the result does not depend on
+ * the number of threads.
+ */
+template <typename Body>
+void parallel_for(std::size_t n, const Body& body, unsigned threads = 0) {
+    parallel_blocks(n, [&](std::size_t, std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) body(i);
+    }, threads);
+}
+
+#endif // PARALLEL_H___
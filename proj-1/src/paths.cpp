@@ -1,8 +1,12 @@
 #include "paths.h"
+#include "search_kernel.h"
 #include "MutablePriorityQueue.h"
+#include "parallel.h"
 
+#include <cassert>
 #include <queue>
 #include <algorithm>
+#include <limits>
 
 namespace paths {
 
@@ -52,157 +56,406 @@ void breadth_first_search(Vertex* source) {
 }
 
 /**
- * Greedy Best-First Search
+ * Greedy Best-First Search, towards the target by straight-line distance
  */
 void greedy_best_first_search(Vertex* source, Vertex* target) {
-    MutablePriorityQueue<Vertex> vertex_queue;
+    search(source, target, policy::length(), policy::greedy_by<policy::euclidean>(), policy::at_target());
+}
 
-    vertex_queue.insert(source);
+/**
+ * Dijkstra late exit
+ */
+void dijkstra_late_exit(Vertex* source, Vertex* target) {
+    search(source, target, policy::length(), policy::zero(), policy::never());
+}
 
-    while (!vertex_queue.empty()) {
-        Vertex* current = vertex_queue.extractMin();
-        if (current == target) break;
+/**
+ * Dijkstra early exit, on any of the heaps in MutablePriorityQueue.h
+ */
+template <typename Queue>
+void dijkstra_early_exit(Vertex* source, Vertex* target) {
+    search<Queue>(source, target, policy::length(), policy::zero(), policy::at_target());
+}
 
-        for (Edge* edge : current->outgoing()) {
-            Vertex* next = edge->target();
+template void dijkstra_early_exit<DaryHeap<Vertex, 2>>(Vertex* source, Vertex* target);
+template void dijkstra_early_exit<DaryHeap<Vertex, 4>>(Vertex* source, Vertex* target);
+template void dijkstra_early_exit<DaryHeap<Vertex, 8>>(Vertex* source, Vertex* target);
+template void dijkstra_early_exit<PairingHeap<Vertex>>(Vertex* source, Vertex* target);
+
+/**
+ * A*
+ */
+void astar_search(Vertex* source, Vertex* target) {
+    search(source, target, policy::length(), policy::euclidean(), policy::at_target());
+}
 
-            if (next->get_path() != nullptr) continue;
+/**
+ * Dijkstra weighted
+ */
+void dijkstra_weight(Vertex* source, Vertex* target) {
+    search(source, target, policy::weight(), policy::zero(), policy::at_target());
+}
 
-            next->set_priority(next->distance(current));
+// ***** Snapshot (CSR) searches
 
-            next->set_path(current);
+/**
+ * Returns the path found by a snapshot search from source to target.
+ */
+path_t get_path(const Snapshot& snap, const SearchContext& context, int source, int target) {
+    if (!context.reached(target)) return path_t();
 
-            vertex_queue.insert(next);
-        }
+    path_t path;
+    int current = target;
+
+    while (current != source && context.get_path(current) != current) {
+        path.push_back(snap.vertex(current));
+        current = context.get_path(current);
+    }
+
+    if (current != source) {
+        return path_t();
+    } else {
+        path.push_back(snap.vertex(source));
+        std::reverse(path.begin(), path.end());
+        return path;
     }
 }
 
 /**
- * Dijkstra late exit
+ * Breadth-First search (snapshot)
  */
-void dijkstra_late_exit(Vertex* source, Vertex* target) {
-    MutablePriorityQueue<Vertex> vertex_queue;
+void breadth_first_search(const Snapshot& snap, SearchContext& context, int source) {
+    std::queue<int> vertex_queue;
 
-    vertex_queue.insert(source);
+    context.reset(source);
+    vertex_queue.push(source);
 
     while (!vertex_queue.empty()) {
-        Vertex* current = vertex_queue.extractMin();
-        //if (current == target) break;
-
-        for (Edge* edge : current->outgoing()) {
-            Vertex* next = edge->target();
+        int current = vertex_queue.front();
+        vertex_queue.pop();
 
-            auto newcost = current->get_cost() + next->distance(current);
+        for (int e = snap.begin(current); e < snap.end(current); ++e) {
+            int next = snap.target(e);
 
-            if (next->get_path() == nullptr) {
-                next->set_cost(newcost);
-                next->set_priority(newcost);
-                next->set_path(current);
-                vertex_queue.insert(next);
-            } else if (newcost < next->get_cost()) {
-                next->set_cost(newcost);
-                next->set_priority(newcost);
-                next->set_path(current);
-                vertex_queue.decreaseKey(next);
+            if (!context.reached(next)) {
+                context.set_path(next, current);
+                context.set_cost(next, context.get_cost(current) + 1);
+                vertex_queue.push(next);
             }
         }
     }
 }
 
 /**
- * Dijkstra early exit
+ * Greedy Best-First Search (snapshot), towards the target by straight-line
+ * distance
  */
-void dijkstra_early_exit(Vertex* source, Vertex* target) {
-    MutablePriorityQueue<Vertex> vertex_queue;
+void greedy_best_first_search(const Snapshot& snap, SearchContext& context, int source, int target) {
+    search(snap, context, source, target, policy::length(), policy::greedy_by<policy::euclidean>(),
+           policy::at_target());
+}
 
-    vertex_queue.insert(source);
+/**
+ * Dijkstra late exit (snapshot)
+ */
+void dijkstra_late_exit(const Snapshot& snap, SearchContext& context, int source, int target) {
+    search(snap, context, source, target, policy::length(), policy::zero(), policy::never());
+}
 
-    while (!vertex_queue.empty()) {
-        Vertex* current = vertex_queue.extractMin();
-        if (current == target) break;
+/**
+ * Dijkstra early exit (snapshot)
+ */
+void dijkstra_early_exit(const Snapshot& snap, SearchContext& context, int source, int target) {
+    search(snap, context, source, target, policy::length(), policy::zero(), policy::at_target());
+}
 
-        for (Edge* edge : current->outgoing()) {
-            Vertex* next = edge->target();
+/**
+ * A* (snapshot)
+ */
+void astar_search(const Snapshot& snap, SearchContext& context, int source, int target) {
+    search(snap, context, source, target, policy::length(), policy::euclidean(), policy::at_target());
+}
 
-            auto newcost = current->get_cost() + next->distance(current);
+/**
+ * Weighted A* (snapshot), the heuristic inflated by factor >= 1
+ */
+void weighted_astar(const Snapshot& snap, SearchContext& context, int source, int target,
+                    double factor) {
+    search(snap, context, source, target, policy::length(), policy::inflated{factor},
+           policy::at_target());
+}
 
-            if (next->get_path() == nullptr) {
-                next->set_cost(newcost);
-                next->set_priority(newcost);
-                next->set_path(current);
-                vertex_queue.insert(next);
-            } else if (newcost < next->get_cost()) {
-                next->set_cost(newcost);
-                next->set_priority(newcost);
-                next->set_path(current);
-                vertex_queue.decreaseKey(next);
-            }
-        }
-    }
+/**
+ * Dijkstra early exit (snapshot, incremental)
+ */
+generator<int> dijkstra_steps(const Snapshot& snap, SearchContext& context, int source, int target) {
+    return search_steps(snap, context, source, target, policy::length(), policy::zero(),
+                        policy::at_target());
 }
 
 /**
- * A*
+ * A* (snapshot, incremental)
  */
-void astar_search(Vertex* source, Vertex* target) {
-    MutablePriorityQueue<Vertex> vertex_queue;
+generator<int> astar_steps(const Snapshot& snap, SearchContext& context, int source, int target) {
+    return search_steps(snap, context, source, target, policy::length(), policy::euclidean(),
+                        policy::at_target());
+}
 
-    vertex_queue.insert(source);
+/**
+ * Dijkstra weighted (snapshot)
+ */
+void dijkstra_weight(const Snapshot& snap, SearchContext& context, int source, int target) {
+    search(snap, context, source, target, policy::weight(), policy::zero(), policy::at_target());
+}
 
-    while (!vertex_queue.empty()) {
-        Vertex* current = vertex_queue.extractMin();
-        if (current == target) break;
+/**
+ * Dijkstra weighted (snapshot, quantised)
+ *
+ * Same search by weight, on the weights rounded to whole metres so that the
+ * queue can be an integer one: every operation is O(1) amortised for Dial's
+ * buckets and O(log C) for the radix heap, C the heaviest edge. Costs are
+ * exact integers, so an entry is stale exactly when its key is larger than
+ * the vertex's cost.
+ */
+template <typename Queue>
+void dijkstra_quantised(const Snapshot& snap, SearchContext& context, Queue& queue,
+                        int source, int target) {
+    search(snap, context, queue, source, target, policy::quantised(), policy::zero(),
+           policy::at_target());
+}
 
-        for (Edge* edge : current->outgoing()) {
-            Vertex* next = edge->target();
+template void dijkstra_quantised<RadixHeap>(const Snapshot& snap, SearchContext& context,
+                                            RadixHeap& queue, int source, int target);
+template void dijkstra_quantised<BucketQueue>(const Snapshot& snap, SearchContext& context,
+                                              BucketQueue& queue, int source, int target);
 
-            auto newcost = current->get_cost() + next->distance(current);
+/**
+ * Dijkstra with early exit (snapshot, indexed heap)
+ */
+void dijkstra_indexed(const Snapshot& snap, SearchContext& context, IndexedHeap<>& queue,
+                      int source, int target) {
+    search(snap, context, queue, source, target, policy::length(), policy::zero(),
+           policy::at_target());
+}
 
-            if (next->get_path() == nullptr) {
-                next->set_cost(newcost);
-                next->set_priority(newcost + target->distance(next));
-                next->set_path(current);
-                vertex_queue.insert(next);
-            } else if (newcost < next->get_cost()) {
-                next->set_cost(newcost);
-                next->set_priority(newcost + target->distance(next));
-                next->set_path(current);
-                vertex_queue.decreaseKey(next);
+// ***** ALT snapshot searches
+
+/**
+ * A* with landmarks (snapshot)
+ */
+void astar_landmarks(const Snapshot& snap, SearchContext& context, const Landmarks& landmarks,
+                     int source, int target) {
+    assert(landmarks.measure() == Landmarks::metric::length);
+    search(snap, context, source, target, policy::length(), policy::landmark_bound{&landmarks},
+           policy::at_target());
+}
+
+/**
+ * A* weighted with landmarks (snapshot). The landmarks must have been
+ * computed from the weights of this same snapshot.
+ */
+void astar_landmarks_weight(const Snapshot& snap, SearchContext& context, const Landmarks& landmarks,
+                            int source, int target) {
+    assert(landmarks.measure() == Landmarks::metric::weight);
+    search(snap, context, source, target, policy::weight(), policy::landmark_bound{&landmarks},
+           policy::at_target());
+}
+
+// ***** Bidirectional snapshot searches
+
+/**
+ * Shared by the bidirectional searches: forward from source in forward,
+ * backward from target over the incoming edges in backward, always
+ * advancing the side with the smaller key. Returns the vertex where the
+ * best path found meets, -1 if target is unreachable.
+ *
+ * With potentials, the searches run on edge lengths reduced by the
+ * average potential p(v) = (d(v, target) - d(source, v)) / 2 (forward) and
+ * -p(v) (backward), which is consistent for both sides at once.
+ *
+ * Either way, every path through a vertex still queued on both sides costs
+ * at least the sum of the two top keys, so the search stops as soon as that
+ * sum reaches the best path found.
+ */
+static int bidirectional_search(const Snapshot& snap, SearchContext& forward, SearchContext& backward,
+                                int source, int target, bool potentials) {
+    auto potential = [&](int v) {
+        return potentials ? (snap.distance(v, target) - snap.distance(source, v)) / 2 : 0.0;
+    };
+
+    forward.reset(source);
+    backward.reset(target);
+    forward.push(source, potential(source));
+    backward.push(target, -potential(target));
+
+    double best = std::numeric_limits<double>::infinity();
+    int meet = -1;
+
+    if (source == target) {
+        best = 0;
+        meet = source;
+    }
+
+    while (forward.skip_stale() && backward.skip_stale()) {
+        if (forward.top().first + backward.top().first >= best) break;
+
+        if (forward.top().first <= backward.top().first) {
+            int current = forward.pop().second;
+
+            for (int e = snap.begin(current); e < snap.end(current); ++e) {
+                int next = snap.target(e);
+
+                auto newcost = forward.get_cost(current) + snap.length(e);
+
+                if (!forward.reached(next) || newcost < forward.get_cost(next)) {
+                    forward.set_cost(next, newcost);
+                    forward.set_path(next, current);
+                    forward.push(next, newcost + potential(next));
+
+                    if (backward.reached(next) && newcost + backward.get_cost(next) < best) {
+                        best = newcost + backward.get_cost(next);
+                        meet = next;
+                    }
+                }
+            }
+        } else {
+            int current = backward.pop().second;
+
+            for (int e = snap.in_begin(current); e < snap.in_end(current); ++e) {
+                int next = snap.in_source(e);
+
+                auto newcost = backward.get_cost(current) + snap.in_length(e);
+
+                if (!backward.reached(next) || newcost < backward.get_cost(next)) {
+                    backward.set_cost(next, newcost);
+                    backward.set_path(next, current);
+                    backward.push(next, newcost - potential(next));
+
+                    if (forward.reached(next) && newcost + forward.get_cost(next) < best) {
+                        best = newcost + forward.get_cost(next);
+                        meet = next;
+                    }
+                }
             }
         }
     }
+
+    return meet;
 }
 
 /**
- * Dijkstra weighted
+ * Bidirectional Dijkstra (snapshot)
  */
-void dijkstra_weight(Vertex* source, Vertex* target) {
-    MutablePriorityQueue<Vertex> vertex_queue;
+int bidirectional_dijkstra(const Snapshot& snap, SearchContext& forward, SearchContext& backward,
+                           int source, int target) {
+    return bidirectional_search(snap, forward, backward, source, target, false);
+}
 
-    vertex_queue.insert(source);
+/**
+ * Bidirectional A* (snapshot)
+ */
+int bidirectional_astar(const Snapshot& snap, SearchContext& forward, SearchContext& backward,
+                        int source, int target) {
+    return bidirectional_search(snap, forward, backward, source, target, true);
+}
 
-    while (!vertex_queue.empty()) {
-        Vertex* current = vertex_queue.extractMin();
-        if (current == target) break;
+/**
+ * Splices the path found by a bidirectional search: source to meet in the
+ * forward tree, then meet to target in the backward tree.
+ */
+path_t get_path(const Snapshot& snap, const SearchContext& forward, const SearchContext& backward,
+                int source, int target, int meet) {
+    if (meet == -1) return path_t();
 
-        for (Edge* edge : current->outgoing()) {
-            Vertex* next = edge->target();
+    path_t path = get_path(snap, forward, source, meet);
 
-            auto newcost = current->get_cost() + edge->get_weight();
+    for (int current = meet; current != target;) {
+        current = backward.get_path(current);
+        path.push_back(snap.vertex(current));
+    }
 
-            if (next->get_path() == nullptr) {
-                next->set_cost(newcost);
-                next->set_priority(newcost);
-                next->set_path(current);
-                vertex_queue.insert(next);
-            } else if (newcost < next->get_cost()) {
-                next->set_cost(newcost);
-                next->set_priority(newcost);
-                next->set_path(current);
-                vertex_queue.decreaseKey(next);
+    return path;
+}
+
+// ***** Distance tables
+
+/**
+ * Fills table[i * targets.size() + j] with the distance from sources[i]
+ * to targets[j], infinite if there is no path: one Dijkstra per source,
+ * stopped once every target is settled, the sources spread over the
+ * threads and each writing its own row.
+ */
+void distance_table(const Snapshot& snap, const std::vector<int>& sources,
+                    const std::vector<int>& targets, double* table, unsigned threads) {
+    std::size_t columns = targets.size();
+
+    std::vector<char> is_target(snap.size(), 0);
+    std::size_t distinct = 0;
+    for (int t : targets) {
+        distinct += !is_target[t];
+        is_target[t] = 1;
+    }
+
+    std::vector<SearchContext> contexts(parallel_threads(threads), SearchContext(snap));
+
+    parallel_blocks(sources.size(), [&](std::size_t block, std::size_t begin, std::size_t end) {
+        SearchContext& context = contexts[block];
+
+        for (std::size_t i = begin; i < end; ++i) {
+            std::size_t settled = 0;
+            auto all_settled = [&](int v, int) {
+                settled += is_target[v];
+                return settled == distinct;
+            };
+
+            search(snap, context, sources[i], -1, policy::length(), policy::zero(), all_settled);
+
+            double* row = table + i * columns;
+            for (std::size_t j = 0; j < columns; ++j) {
+                bool reached = context.reached(targets[j]);
+                row[j] = reached ? context.get_cost(targets[j]) : std::numeric_limits<double>::infinity();
             }
         }
-    }
+    }, threads, 1);
+}
+
+// ***** Budget-bounded searches
+
+/**
+ * Isochrone (snapshot): Dijkstra from source by Cost, stopped at the first
+ * vertex settled beyond the budget, so it only costs as much as the region
+ * it returns and the edges just past it. An edge out of the region whose
+ * far end is beyond the budget along it is a boundary edge, even if its
+ * target is inside by some other path. The result's buffers are reused
+ * across calls.
+ */
+template <typename Cost>
+void isochrone(const Snapshot& snap, SearchContext& context, int source, double budget,
+               isochrone_t& result) {
+    Cost cost;
+
+    result.vertices.clear();
+    result.boundary.clear();
+
+    auto beyond = [&](int v, int) {
+        return context.get_cost(v) > budget;
+    };
+
+    auto collect = [&](int v) {
+        if (beyond(v, -1)) return;
+        result.vertices.push_back(v);
+
+        for (int e = snap.begin(v); e < snap.end(v); ++e) {
+            if (context.get_cost(v) + cost(snap, e) > budget) result.boundary.push_back(e);
+        }
+    };
+
+    search(snap, context, source, -1, cost, policy::zero(), beyond, collect);
 }
 
+template void isochrone<policy::length>(const Snapshot& snap, SearchContext& context, int source,
+                                        double budget, isochrone_t& result);
+template void isochrone<policy::weight>(const Snapshot& snap, SearchContext& context, int source,
+                                        double budget, isochrone_t& result);
+
 }
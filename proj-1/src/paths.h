@@ -2,6 +2,12 @@
 #define PATHS_H___
 
 #include "graph.h"
+#include "snapshot.h"
+#include "search_context.h"
+#include "landmarks.h"
+#include "bucket_queue.h"
+#include "indexed_heap.h"
+#include "search_kernel.h"
 
 #include <vector>
 
@@ -15,12 +21,102 @@ void greedy_best_first_search(Vertex* source, Vertex* target);
 
 void dijkstra_late_exit(Vertex* source, Vertex* target);
 
+// Queue is any heap in MutablePriorityQueue.h with arity 2, 4 or 8
+template <typename Queue = MutablePriorityQueue<Vertex>>
 void dijkstra_early_exit(Vertex* source, Vertex* target);
 
 void astar_search(Vertex* source, Vertex* target);
 
 void dijkstra_weight(Vertex* source, Vertex* target);
 
+// ***** Snapshot (CSR) searches, on snapshot vertex indices.
+// Each query resets the context and leaves its search tree there.
+
+path_t get_path(const Snapshot& snap, const SearchContext& context, int source, int target);
+
+void breadth_first_search(const Snapshot& snap, SearchContext& context, int source);
+
+void greedy_best_first_search(const Snapshot& snap, SearchContext& context, int source, int target);
+
+void dijkstra_late_exit(const Snapshot& snap, SearchContext& context, int source, int target);
+
+void dijkstra_early_exit(const Snapshot& snap, SearchContext& context, int source, int target);
+
+void astar_search(const Snapshot& snap, SearchContext& context, int source, int target);
+
+void weighted_astar(const Snapshot& snap, SearchContext& context, int source, int target,
+                    double factor);
+
+void dijkstra_weight(const Snapshot& snap, SearchContext& context, int source, int target);
+// *****
+
+// ***** Incremental snapshot searches, coroutines yielding every vertex as it
+// is settled, up to the target. snap and context must outlive them.
+
+generator<int> dijkstra_steps(const Snapshot& snap, SearchContext& context, int source, int target);
+
+generator<int> astar_steps(const Snapshot& snap, SearchContext& context, int source, int target);
+// *****
+
+// ***** Quantised snapshot search, by weight in whole metres.
+// Queue is RadixHeap or BucketQueue (IntegerQueue by default); the costs it
+// leaves in the context are whole metres too.
+
+template <typename Queue = IntegerQueue>
+void dijkstra_quantised(const Snapshot& snap, SearchContext& context, Queue& queue,
+                        int source, int target);
+// *****
+
+// ***** Snapshot search on an IndexedHeap of snap.size() ids, by length.
+// Keys are decreased in place, so the queue holds no stale entries.
+
+void dijkstra_indexed(const Snapshot& snap, SearchContext& context, IndexedHeap<>& queue,
+                      int source, int target);
+// *****
+
+// ***** ALT snapshot searches, on landmarks by length and by weight.
+
+void astar_landmarks(const Snapshot& snap, SearchContext& context, const Landmarks& landmarks,
+                     int source, int target);
+
+void astar_landmarks_weight(const Snapshot& snap, SearchContext& context, const Landmarks& landmarks,
+                            int source, int target);
+// *****
+
+// ***** Bidirectional snapshot searches, forward and backward contexts.
+// They return the vertex where the path meets, -1 if there is no path.
+
+int bidirectional_dijkstra(const Snapshot& snap, SearchContext& forward, SearchContext& backward,
+                           int source, int target);
+
+int bidirectional_astar(const Snapshot& snap, SearchContext& forward, SearchContext& backward,
+                        int source, int target);
+
+path_t get_path(const Snapshot& snap, const SearchContext& forward, const SearchContext& backward,
+                int source, int target, int meet);
+// *****
+
+// ***** Distance tables, row-major into table[sources.size() * targets.size()].
+// ContractionHierarchy::distance_table does the same with bucket joins.
+
+void distance_table(const Snapshot& snap, const std::vector<int>& sources,
+                    const std::vector<int>& targets, double* table, unsigned threads = 0);
+// *****
+
+// ***** Budget-bounded searches (isochrones), everything within budget of
+// source by Cost, policy::length or policy::weight. The costs of the
+// vertices stay in the context.
+
+struct isochrone_t {
+    std::vector<int> vertices; // Settled within the budget, by increasing cost
+    std::vector<int> boundary; // Edge slots leaving them where the budget runs out
+};
+
+template <typename Cost = policy::length>
+void isochrone(const Snapshot& snap, SearchContext& context, int source, double budget,
+               isochrone_t& result);
+// *****
+
 }
 
 #endif // PATHS_H___
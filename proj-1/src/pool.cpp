@@ -0,0 +1,64 @@
+#include "pool.h"
+#include "parallel.h"
+
+/**
+ * A pool of threads workers in all, the caller included (threads = 0 uses
+ * every core).
+ */
+ThreadPool::ThreadPool(unsigned threads) {
+    unsigned workers = parallel_threads(threads);
+    _threads.reserve(workers - 1);
+
+    for (unsigned worker = 1; worker < workers; ++worker) {
+        _threads.emplace_back(&ThreadPool::work, this, worker);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _wake.notify_all();
+
+    for (std::thread& thread : _threads) thread.join();
+}
+
+unsigned ThreadPool::size() const {
+    return _threads.size() + 1;
+}
+
+void ThreadPool::work(unsigned worker) {
+    std::uint64_t seen = 0;
+
+    while (true) {
+        const std::function<void(unsigned)>* job;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wake.wait(lock, [&] { return _stop || _round != seen; });
+            if (_stop) return;
+            seen = _round;
+            job = _job;
+        }
+
+        (*job)(worker);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (--_running == 0) _done.notify_one();
+    }
+}
+
+void ThreadPool::run(const std::function<void(unsigned)>& job) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _job = &job;
+        _running = _threads.size();
+        ++_round;
+    }
+    _wake.notify_all();
+
+    job(0);
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _done.wait(lock, [&] { return _running == 0; });
+}
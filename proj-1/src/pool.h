@@ -0,0 +1,46 @@
+#ifndef POOL_H___
+#define POOL_H___
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed set of worker threads that stay alive between jobs, for callers
+ * that run many short parallel jobs and cannot afford parallel_for's
+ * thread start-up every time.
+ *
+ * run(job) calls job(worker) once on every worker, numbered
+ * 0..size()-1, and returns when all of them are done. The calling thread
+ * is worker 0, so a pool of size 1 has no threads of its own. Jobs split
+ * their work among the workers themselves, typically through an atomic
+ * counter, and index per-worker scratch state by the worker number.
+ */
+class ThreadPool {
+private:
+    std::vector<std::thread> _threads;
+
+    std::mutex _mutex;
+    std::condition_variable _wake, _done;
+    const std::function<void(unsigned)>* _job = nullptr;
+    std::uint64_t _round = 0;
+    unsigned _running = 0;
+    bool _stop = false;
+
+    void work(unsigned worker);
+
+public:
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const;
+    void run(const std::function<void(unsigned)>& job);
+};
+
+#endif // POOL_H___
@@ -0,0 +1,333 @@
+#include "reachability.h"
+
+#include <algorithm>
+#include <utility>
+
+Reachability::Reachability(const Graph& graph): _graph(graph) {
+    std::size_t n = graph.V.size();
+
+    _component.assign(n, -1);
+    _order.assign(n, -1);
+    _low.assign(n, 0);
+    _subset.assign(n, 0);
+
+    std::vector<int> vertices(n);
+    for (std::size_t v = 0; v < n; ++v) vertices[v] = v;
+
+    tarjan(vertices);
+}
+
+int Reachability::new_component() {
+    if (!_free.empty()) {
+        int c = _free.back();
+        _free.pop_back();
+        return c;
+    }
+
+    _members.emplace_back();
+    _out.emplace_back();
+    _in.emplace_back();
+    return _members.size() - 1;
+}
+
+/**
+ * Removes component c, with all its condensation edges.
+ */
+void Reachability::retire(int c) {
+    for (const auto& entry : _out[c]) _in[entry.first].erase(c);
+    for (const auto& entry : _in[c]) _out[entry.first].erase(c);
+
+    _out[c].clear();
+    _in[c].clear();
+    _members[c].clear();
+    _free.push_back(c);
+}
+
+void Reachability::link(int a, int b, int count) {
+    _out[a][b] += count;
+    _in[b][a] += count;
+}
+
+void Reachability::unlink(int a, int b) {
+    if (--_out[a][b] == 0) {
+        _out[a].erase(b);
+        _in[b].erase(a);
+    } else {
+        --_in[b][a];
+    }
+}
+
+/**
+ * Iterative Tarjan over the subgraph induced by vertices (clear edges with
+ * both ends in the set), giving each SCC a new component, followed by the
+ * condensation edges between the new components and to/from the rest.
+ */
+void Reachability::tarjan(const std::vector<int>& vertices) {
+    unsigned subset = ++_subset_generation;
+    for (int v : vertices) {
+        _subset[v] = subset;
+        _order[v] = -1;
+    }
+
+    auto in_subset = [&](const Edge* edge, const Vertex* vertex) {
+        return edge->is_clear() && _subset[vertex->index()] == subset;
+    };
+
+    // Frames of (vertex, position of the next outgoing edge to follow)
+    std::vector<std::pair<int, std::size_t>> frames;
+    std::vector<int> stack;
+    std::vector<int> created;
+    int counter = 0;
+
+    for (int root : vertices) {
+        if (_order[root] != -1) continue;
+
+        _order[root] = _low[root] = counter++;
+        stack.push_back(root);
+        frames.push_back({root, 0});
+
+        while (!frames.empty()) {
+            int u = frames.back().first;
+            std::size_t& next = frames.back().second;
+            const EdgeList& outgoing = _graph.V[u]->all_outgoing();
+
+            if (next < outgoing.size()) {
+                Edge* edge = outgoing[next++];
+                Vertex* target = edge->target();
+                if (!in_subset(edge, target)) continue;
+
+                int w = target->index();
+                if (_order[w] == -1) {
+                    _order[w] = _low[w] = counter++;
+                    stack.push_back(w);
+                    frames.push_back({w, 0});
+                } else if (_component[w] == -1) { // still on the stack
+                    _low[u] = std::min(_low[u], _order[w]);
+                }
+                continue;
+            }
+
+            frames.pop_back();
+            if (!frames.empty()) {
+                int parent = frames.back().first;
+                _low[parent] = std::min(_low[parent], _low[u]);
+            }
+
+            if (_low[u] == _order[u]) {
+                int c = new_component();
+                int w;
+                do {
+                    w = stack.back();
+                    stack.pop_back();
+                    _component[w] = c;
+                    _members[c].push_back(w);
+                } while (w != u);
+                created.push_back(c);
+            }
+        }
+    }
+
+    // Condensation edges leaving and entering the new components. Edges
+    // between two new components are seen once, from their source.
+    for (int c : created) {
+        for (int u : _members[c]) {
+            for (Edge* edge : _graph.V[u]->outgoing()) {
+                int d = _component[edge->target()->index()];
+                if (d != c) link(c, d);
+            }
+            for (Edge* edge : _graph.V[u]->incident()) {
+                Vertex* source = edge->source();
+                if (_subset[source->index()] == subset) continue;
+                link(_component[source->index()], c);
+            }
+        }
+    }
+}
+
+/**
+ * Whether edge's source still reaches its target, inside their component,
+ * without using edge. If so the component survives the edge's removal.
+ * Breadth-first, as the detour is usually a few blocks long.
+ */
+bool Reachability::connected_without(const Edge* edge) {
+    int c = _component[edge->source()->index()];
+    int target = edge->target()->index();
+    unsigned subset = ++_subset_generation;
+
+    std::vector<int> frontier{edge->source()->index()};
+    _subset[frontier.front()] = subset;
+
+    for (std::size_t i = 0; i < frontier.size(); ++i) {
+        for (Edge* next : _graph.V[frontier[i]]->outgoing()) {
+            if (next == edge) continue;
+            int w = next->target()->index();
+            if (w == target) return true;
+            if (_component[w] != c || _subset[w] == subset) continue;
+            _subset[w] = subset;
+            frontier.push_back(w);
+        }
+    }
+
+    return false;
+}
+
+unsigned Reachability::next_generation() const {
+    if (_stamp.size() < _members.size()) _stamp.resize(_members.size(), 0);
+
+    if (++_generation == 0) {
+        std::fill(_stamp.begin(), _stamp.end(), 0);
+        _generation = 1;
+    }
+    return _generation;
+}
+
+/**
+ * Stamps every component reachable from c in the condensation DAG.
+ */
+void Reachability::mark_reachable(int c) const {
+    unsigned generation = next_generation();
+
+    _stack.assign(1, c);
+    _stamp[c] = generation;
+
+    while (!_stack.empty()) {
+        int a = _stack.back();
+        _stack.pop_back();
+
+        for (const auto& entry : _out[a]) {
+            if (_stamp[entry.first] != generation) {
+                _stamp[entry.first] = generation;
+                _stack.push_back(entry.first);
+            }
+        }
+    }
+}
+
+std::size_t Reachability::components() const {
+    return _members.size() - _free.size();
+}
+
+int Reachability::component(const Vertex* vertex) const {
+    return _component[vertex->index()];
+}
+
+/**
+ * Whether target can be reached from source through clear edges.
+ */
+bool Reachability::reaches(const Vertex* source, const Vertex* target) const {
+    int a = component(source), b = component(target);
+    if (a == b) return true;
+
+    unsigned generation = next_generation();
+
+    _stack.assign(1, a);
+    _stamp[a] = generation;
+
+    while (!_stack.empty()) {
+        int c = _stack.back();
+        _stack.pop_back();
+
+        for (const auto& entry : _out[c]) {
+            if (entry.first == b) return true;
+            if (_stamp[entry.first] != generation) {
+                _stamp[entry.first] = generation;
+                _stack.push_back(entry.first);
+            }
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Flags, by vertex storage index, the vertices reachable from source.
+ */
+std::vector<bool> Reachability::reachable(const Vertex* source) const {
+    mark_reachable(component(source));
+
+    std::vector<bool> result(_component.size());
+    for (std::size_t v = 0; v < result.size(); ++v) {
+        result[v] = _stamp[_component[v]] == _generation;
+    }
+    return result;
+}
+
+/**
+ * Call after edge became clear. If its target's component reaches its
+ * source's, the edge closes a cycle and every component on it merges.
+ */
+void Reachability::insert(const Edge* edge) {
+    int a = component(edge->source()), b = component(edge->target());
+    if (a == b) return;
+
+    link(a, b);
+    if (!reaches(edge->target(), edge->source())) return;
+
+    // Components on a cycle through the edge: reachable from b, and
+    // reaching a.
+    mark_reachable(b);
+    std::vector<unsigned> forward = _stamp;
+    unsigned forward_generation = _generation;
+
+    std::vector<int> cycle;
+    unsigned generation = next_generation();
+    _stack.assign(1, a);
+    _stamp[a] = generation;
+
+    while (!_stack.empty()) {
+        int c = _stack.back();
+        _stack.pop_back();
+        cycle.push_back(c);
+
+        for (const auto& entry : _in[c]) {
+            int d = entry.first;
+            if (_stamp[d] != generation && forward[d] == forward_generation) {
+                _stamp[d] = generation;
+                _stack.push_back(d);
+            }
+        }
+    }
+
+    // Merge them into a new component, keeping the outside edges.
+    int merged = new_component();
+    std::vector<std::pair<int, int>> outgoing, incoming;
+
+    for (int c : cycle) {
+        for (const auto& entry : _out[c]) {
+            if (_stamp[entry.first] != generation) outgoing.push_back(entry);
+        }
+        for (const auto& entry : _in[c]) {
+            if (_stamp[entry.first] != generation) incoming.push_back(entry);
+        }
+        for (int u : _members[c]) {
+            _component[u] = merged;
+            _members[merged].push_back(u);
+        }
+    }
+
+    for (int c : cycle) retire(c);
+
+    for (const auto& entry : outgoing) link(merged, entry.first, entry.second);
+    for (const auto& entry : incoming) link(entry.first, merged, entry.second);
+}
+
+/**
+ * Call after edge was accidented. Only an edge inside a component can
+ * split it, and only if nothing else leads from its source to its target.
+ */
+void Reachability::erase(const Edge* edge) {
+    int a = component(edge->source()), b = component(edge->target());
+
+    if (a != b) {
+        unlink(a, b);
+        return;
+    }
+
+    if (connected_without(edge)) return;
+
+    std::vector<int> vertices = std::move(_members[a]);
+    retire(a);
+
+    for (int v : vertices) _component[v] = -1;
+    tarjan(vertices);
+}
@@ -0,0 +1,71 @@
+#ifndef REACHABILITY_H___
+#define REACHABILITY_H___
+
+#include "graph.h"
+
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Strongly connected components of the clear edges, and their condensation
+ * DAG, for answering "can source reach target" without a search.
+ *
+ * Two vertices in the same component reach each other; otherwise target is
+ * reachable iff its component is reachable from source's in the DAG, which
+ * is usually tiny next to the graph (road maps are mostly one big
+ * component). Built once after loading (Graph::reachability()) with an
+ * iterative Tarjan, and then kept up to date as edges are accidented and
+ * fixed: a fix merges the components on the cycle it closes, and an
+ * accident only recomputes the component it splits, if any.
+ *
+ * Queries use scratch state, so the index is not thread-safe.
+ */
+class Reachability {
+private:
+    const Graph& _graph;
+
+    // Component of each vertex (by storage index), and the members of each
+    // component (empty for retired component ids, kept in _free)
+    std::vector<int> _component;
+    std::vector<std::vector<int>> _members;
+    std::vector<int> _free;
+
+    // Condensation edges, with the number of clear edges each stands for
+    std::vector<std::unordered_map<int, int>> _out;
+    std::vector<std::unordered_map<int, int>> _in;
+
+    // Tarjan and detour search scratch, by vertex
+    std::vector<int> _order, _low;
+    std::vector<unsigned> _subset;
+    unsigned _subset_generation = 0;
+
+    // Traversal scratch, by component
+    mutable std::vector<unsigned> _stamp;
+    mutable unsigned _generation = 0;
+    mutable std::vector<int> _stack;
+
+    int new_component();
+    void retire(int c);
+    void link(int a, int b, int count = 1);
+    void unlink(int a, int b);
+
+    void tarjan(const std::vector<int>& vertices);
+    bool connected_without(const Edge* edge);
+
+    unsigned next_generation() const;
+    void mark_reachable(int c) const;
+
+public:
+    explicit Reachability(const Graph& graph);
+
+    std::size_t components() const;
+    int component(const Vertex* vertex) const;
+
+    bool reaches(const Vertex* source, const Vertex* target) const;
+    std::vector<bool> reachable(const Vertex* source) const;
+
+    void insert(const Edge* edge);
+    void erase(const Edge* edge);
+};
+
+#endif // REACHABILITY_H___
@@ -0,0 +1,243 @@
+#include "replanner.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+static constexpr double inf = std::numeric_limits<double>::infinity();
+
+// D* Lite needs strictly positive costs: across a zero-cost cycle (an edge
+// pair between coincident vertices) two vertices can keep vouching for each
+// other's stale g after the rest of the graph got more expensive.
+static constexpr double min_cost = 1e-6;
+
+DStarLite::DStarLite(const Graph& graph, Vertex* goal):
+    _graph(graph), _goal(goal->index()),
+    _seen(graph._dropped_changes + graph._changes.size()) {
+    std::size_t n = graph.V.size(), m = graph.E.size();
+
+    _g.resize(n);
+    _rhs.resize(n);
+    _key.resize(n);
+    _costs.resize(m);
+    _sources.resize(m);
+    _targets.resize(m);
+
+    _out_offsets.assign(n + 1, 0);
+    _in_offsets.assign(n + 1, 0);
+
+    for (std::size_t e = 0; e < m; ++e) {
+        Edge* edge = graph.E[e];
+        _sources[e] = edge->source()->index();
+        _targets[e] = edge->target()->index();
+        ++_out_offsets[_sources[e] + 1];
+        ++_in_offsets[_targets[e] + 1];
+    }
+
+    for (std::size_t v = 0; v < n; ++v) {
+        _out_offsets[v + 1] += _out_offsets[v];
+        _in_offsets[v + 1] += _in_offsets[v];
+    }
+
+    std::vector<int> out_fill(_out_offsets.begin(), _out_offsets.end() - 1);
+    std::vector<int> in_fill(_in_offsets.begin(), _in_offsets.end() - 1);
+    _out_edges.resize(m);
+    _in_edges.resize(m);
+
+    for (std::size_t e = 0; e < m; ++e) {
+        _out_edges[out_fill[_sources[e]]++] = e;
+        _in_edges[in_fill[_targets[e]]++] = e;
+    }
+
+    restart();
+}
+
+double DStarLite::cost(int e) const {
+    return _graph.E[e]->is_accidented() ? inf : std::max(_graph._weights[e], min_cost);
+}
+
+/**
+ * rhs(u) = min over the edges u->v of cost(u->v) + g(v).
+ */
+void DStarLite::update_rhs(int u) {
+    if (u == _goal) return;
+
+    double rhs = inf;
+    for (int i = _out_offsets[u]; i < _out_offsets[u + 1]; ++i) {
+        int e = _out_edges[i];
+        rhs = std::min(rhs, _costs[e] + _g[_targets[e]]);
+    }
+    _rhs[u] = rhs;
+}
+
+/**
+ * Queues u if it is locally inconsistent, dequeues it otherwise.
+ */
+void DStarLite::update_queue(int u) {
+    if (_g[u] != _rhs[u]) {
+        double key = std::min(_g[u], _rhs[u]);
+        if (key == _key[u]) return;
+
+        _key[u] = key;
+        _queue.push_back({key, u});
+        std::push_heap(_queue.begin(), _queue.end(), std::greater<entry_t>());
+    } else {
+        _key[u] = inf;
+    }
+}
+
+/**
+ * Edge e's contribution cost(e) + g(target) to the rhs of its source was
+ * previous. Only when the contribution drops, or when it defined the rhs
+ * and grows, does the rhs change.
+ */
+void DStarLite::update_edge(int e, double previous) {
+    int u = _sources[e];
+    if (u == _goal) return;
+
+    double current = _costs[e] + _g[_targets[e]];
+
+    if (current < previous) {
+        _rhs[u] = std::min(_rhs[u], current);
+    } else if (current > previous && _rhs[u] == previous) {
+        update_rhs(u);
+    } else {
+        return;
+    }
+    update_queue(u);
+}
+
+/**
+ * Brings edge e's cost up to date with the graph.
+ */
+void DStarLite::update_cost(int e) {
+    double updated = cost(e);
+    if (updated == _costs[e]) return;
+
+    double previous = _costs[e] + _g[_targets[e]];
+    _costs[e] = updated;
+    update_edge(e, previous);
+}
+
+/**
+ * Drops the search tree and reads every edge cost afresh, leaving only the
+ * goal queued.
+ */
+void DStarLite::restart() {
+    std::fill(_g.begin(), _g.end(), inf);
+    std::fill(_rhs.begin(), _rhs.end(), inf);
+    std::fill(_key.begin(), _key.end(), inf);
+    for (std::size_t e = 0; e < _costs.size(); ++e) _costs[e] = cost(e);
+    _queue.clear();
+
+    _rhs[_goal] = 0;
+    update_queue(_goal);
+}
+
+/**
+ * Expands inconsistent vertices in key order until the start is consistent
+ * and no queued vertex can improve it.
+ */
+void DStarLite::compute() {
+    int s = _start;
+
+    while (!_queue.empty()) {
+        entry_t top = _queue.front();
+
+        if (top.first != _key[top.second]) {
+            std::pop_heap(_queue.begin(), _queue.end(), std::greater<entry_t>());
+            _queue.pop_back();
+            continue;
+        }
+
+        if (top.first >= std::min(_g[s], _rhs[s]) && _g[s] == _rhs[s]) break;
+
+        std::pop_heap(_queue.begin(), _queue.end(), std::greater<entry_t>());
+        _queue.pop_back();
+
+        int u = top.second;
+        double previous = _g[u];
+        _key[u] = inf;
+        ++_expanded;
+
+        if (_g[u] > _rhs[u]) {
+            _g[u] = _rhs[u];
+        } else {
+            _g[u] = inf;
+            update_rhs(u);
+            update_queue(u);
+        }
+
+        for (int i = _in_offsets[u]; i < _in_offsets[u + 1]; ++i) {
+            int e = _in_edges[i];
+            update_edge(e, _costs[e] + previous);
+        }
+    }
+}
+
+/**
+ * Brings the search tree up to date with the graph's current weights and
+ * accidents, and plans from start.
+ */
+void DStarLite::replan(Vertex* start) {
+    _start = start->index();
+    _expanded = 0;
+
+    const std::vector<int>& changes = _graph._changes;
+    std::size_t dropped = _graph._dropped_changes;
+
+    bool missed = _seen < dropped;
+
+    if (missed || dropped + changes.size() - _seen > _key.size() / 4) {
+        restart();
+    } else {
+        for (std::size_t i = _seen - dropped; i < changes.size(); ++i) update_cost(changes[i]);
+    }
+    _seen = dropped + changes.size();
+
+    compute();
+}
+
+/**
+ * The best path from the start to the goal, following the cheapest
+ * successor of each vertex. Empty if the goal is unreachable.
+ */
+path_t DStarLite::path() const {
+    if (_g[_start] == inf) return path_t();
+
+    path_t path{_graph.V[_start]};
+    int current = _start;
+
+    while (current != _goal) {
+        int best = -1;
+        double best_cost = inf;
+
+        for (int i = _out_offsets[current]; i < _out_offsets[current + 1]; ++i) {
+            int e = _out_edges[i];
+            double cost = _costs[e] + _g[_targets[e]];
+            if (cost < best_cost) {
+                best = _targets[e];
+                best_cost = cost;
+            }
+        }
+
+        if (best == -1) return path_t();
+        path.push_back(_graph.V[current = best]);
+    }
+
+    return path;
+}
+
+/**
+ * Weight of the best path from the start to the goal.
+ */
+double DStarLite::cost() const {
+    return _g[_start];
+}
+
+/**
+ * Number of vertices expanded by the last replan().
+ */
+std::size_t DStarLite::expanded() const {
+    return _expanded;
+}
@@ -0,0 +1,81 @@
+#ifndef REPLANNER_H___
+#define REPLANNER_H___
+
+#include "graph.h"
+
+#include <utility>
+#include <vector>
+
+/**
+ * Incremental shortest path planner by weight towards a fixed goal
+ * (D* Lite), for the traffic simulations.
+ *
+ * The planner searches backwards from the goal, so g(v) is the weight of
+ * the best path from v to the goal, and keeps its search tree between
+ * calls to replan(). Each replan() reads only the edges the graph recorded
+ * as changed since the last one, and repairs the vertices whose distance to
+ * the goal may have changed. Moving the start towards the goal costs
+ * nothing by itself.
+ *
+ * The repair only pays off while the changes are sparse: accidents, fixes
+ * and the odd set_weight() between ticks. A regenerate() changes every
+ * clear edge and re-keys most vertices, and repairing the tree after one
+ * costs more than a fresh Dijkstra. So when the changes outnumber a
+ * quarter of the vertices, or the planner missed a whole regenerate(),
+ * replan() drops the tree and searches afresh from the goal. That is no
+ * faster than a Dijkstra either: a simulation that regenerates every tick
+ * gains nothing from D* Lite.
+ *
+ * Weights can be arbitrarily smaller than the straight-line length of an
+ * edge, so there is no admissible geometric heuristic, and the planner
+ * runs with h = 0. Without a heuristic the start can move freely and the
+ * km key correction of D* Lite is unnecessary.
+ */
+class DStarLite {
+private:
+    using entry_t = std::pair<double, int>;
+
+    const Graph& _graph;
+    const int _goal;
+    int _start = -1;
+
+    // Forward and backward adjacency (edge indices), and edge endpoints
+    std::vector<int> _out_offsets, _out_edges;
+    std::vector<int> _in_offsets, _in_edges;
+    std::vector<int> _sources, _targets;
+
+    std::vector<double> _g;
+    std::vector<double> _rhs;
+
+    // Key each vertex is queued with, infinity if it is not in the queue
+    std::vector<double> _key;
+
+    // Edge costs the current search tree was built with, and how many of
+    // the graph's changes they account for
+    std::vector<double> _costs;
+    std::size_t _seen;
+
+    // Lazy-deletion binary min-heap of (key, vertex) entries
+    std::vector<entry_t> _queue;
+
+    std::size_t _expanded = 0;
+
+    double cost(int e) const;
+    void update_rhs(int u);
+    void update_queue(int u);
+    void update_edge(int e, double previous);
+    void update_cost(int e);
+    void restart();
+    void compute();
+
+public:
+    explicit DStarLite(const Graph& graph, Vertex* goal);
+
+    void replan(Vertex* start);
+
+    path_t path() const;
+    double cost() const;
+    std::size_t expanded() const;
+};
+
+#endif // REPLANNER_H___
@@ -0,0 +1,79 @@
+#include "router.h"
+#include "paths.h"
+
+#include <atomic>
+#include <cassert>
+#include <limits>
+
+static constexpr double inf = std::numeric_limits<double>::infinity();
+
+BatchRouter::BatchRouter(std::shared_ptr<const Snapshot> snap, engine method,
+                         const ContractionHierarchy* hierarchy, unsigned threads):
+    _snap(std::move(snap)), _hierarchy(hierarchy), _engine(method), _pool(threads) {
+    assert(method != engine::hierarchy || hierarchy != nullptr);
+
+    bool bidirectional = method == engine::bidirectional || method == engine::hierarchy;
+
+    _forward.assign(_pool.size(), SearchContext(*_snap));
+    if (bidirectional) _backward.assign(_pool.size(), SearchContext(*_snap));
+}
+
+unsigned BatchRouter::threads() const {
+    return _pool.size();
+}
+
+/**
+ * One query on the worker's contexts: its cost, infinite if there is no
+ * path, and the path itself if asked for.
+ */
+double BatchRouter::answer(unsigned worker, int source, int target, path_t* path) {
+    SearchContext& forward = _forward[worker];
+
+    if (_engine == engine::dijkstra || _engine == engine::astar) {
+        if (_engine == engine::dijkstra) {
+            paths::dijkstra_early_exit(*_snap, forward, source, target);
+        } else {
+            paths::astar_search(*_snap, forward, source, target);
+        }
+
+        bool reached = forward.reached(target);
+        if (path) *path = paths::get_path(*_snap, forward, source, target);
+        return reached ? forward.get_cost(target) : inf;
+    }
+
+    SearchContext& backward = _backward[worker];
+    int meet;
+
+    if (_engine == engine::bidirectional) {
+        meet = paths::bidirectional_astar(*_snap, forward, backward, source, target);
+        if (path) *path = paths::get_path(*_snap, forward, backward, source, target, meet);
+    } else {
+        meet = _hierarchy->search(forward, backward, source, target);
+        if (path) *path = _hierarchy->get_path(forward, backward, source, target, meet);
+    }
+
+    return meet == -1 ? inf : forward.get_cost(meet) + backward.get_cost(meet);
+}
+
+/**
+ * Answers every query: costs[i] for queries[i], infinite if there is no
+ * path, and paths[i] too if paths is not null. Both arrays are the
+ * caller's, queries.size() long.
+ */
+void BatchRouter::route(const std::vector<query_t>& queries, double* costs, path_t* paths) {
+    std::atomic<std::size_t> next(0);
+
+    _pool.run([&](unsigned worker) {
+        while (true) {
+            std::size_t begin = next.fetch_add(ROUTER_CHUNK);
+            if (begin >= queries.size()) break;
+
+            std::size_t end = std::min(begin + ROUTER_CHUNK, queries.size());
+
+            for (std::size_t i = begin; i < end; ++i) {
+                auto [source, target] = queries[i];
+                costs[i] = answer(worker, source, target, paths ? &paths[i] : nullptr);
+            }
+        }
+    });
+}
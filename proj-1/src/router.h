@@ -0,0 +1,53 @@
+#ifndef ROUTER_H___
+#define ROUTER_H___
+
+#include "snapshot.h"
+#include "search_context.h"
+#include "hierarchy.h"
+#include "pool.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Queries a worker claims at a time
+#define ROUTER_CHUNK ((std::size_t)16)
+
+using query_t = std::pair<int, int>; // (source, target) snapshot indices
+
+/**
+ * Answers batches of point-to-point queries by length on a thread pool.
+ *
+ * The snapshot searches keep their state in SearchContexts, so every
+ * worker owns its own contexts and the whole batch shares the snapshot
+ * read-only. Workers claim the queries in small chunks as they go, which
+ * keeps them busy even when query costs differ wildly. The pool and the
+ * contexts live as long as the router, so a batch pays for neither.
+ *
+ * The router holds on to its snapshot, but must not outlive the hierarchy
+ * it was built with.
+ */
+class BatchRouter {
+public:
+    enum class engine : char { dijkstra, astar, bidirectional, hierarchy };
+
+private:
+    const std::shared_ptr<const Snapshot> _snap;
+    const ContractionHierarchy* const _hierarchy;
+    const engine _engine;
+
+    ThreadPool _pool;
+    std::vector<SearchContext> _forward, _backward;
+
+    double answer(unsigned worker, int source, int target, path_t* path);
+
+public:
+    explicit BatchRouter(std::shared_ptr<const Snapshot> snap, engine method = engine::astar,
+                         const ContractionHierarchy* hierarchy = nullptr, unsigned threads = 0);
+
+    unsigned threads() const;
+
+    void route(const std::vector<query_t>& queries, double* costs, path_t* paths = nullptr);
+};
+
+#endif // ROUTER_H___
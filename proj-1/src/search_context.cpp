@@ -0,0 +1,27 @@
+#include "search_context.h"
+
+#include <algorithm>
+
+SearchContext::SearchContext(const Snapshot& snap):
+    SearchContext(snap.size()) {}
+
+SearchContext::SearchContext(std::size_t size):
+    _path(size, -1), _cost(size, 0), _priority(size, 0), _stamp(size, 0) {}
+
+std::size_t SearchContext::size() const {
+    return _path.size();
+}
+
+/**
+ * Forgets the previous query and makes source the root of a new one.
+ * The stamps are only swept when the generation counter wraps around.
+ */
+void SearchContext::reset(int source) {
+    if (++_generation == 0) {
+        std::fill(_stamp.begin(), _stamp.end(), 0);
+        _generation = 1;
+    }
+    _queue.clear();
+
+    set_path(source, source);
+}
@@ -0,0 +1,152 @@
+#ifndef SEARCH_CONTEXT_H___
+#define SEARCH_CONTEXT_H___
+
+#include "snapshot.h"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/**
+ * Per-query search state for the snapshot searches: predecessor, cost and
+ * priority of every snapshot vertex, plus the search queue.
+ *
+ * This is the state that Vertex carries for the pointer-based searches,
+ * moved into flat arrays owned by the caller. The snapshot is never written
+ * to, so any number of contexts can run queries concurrently against the
+ * same snapshot, one context per thread. A context is reused across queries
+ * to keep its arrays allocated, and resetting it is O(1): the state of a
+ * vertex is stamped with the query's generation, and state left over from
+ * earlier generations reads as unreached. A query therefore only costs as
+ * much as the part of the graph it actually explores.
+ */
+class SearchContext {
+public:
+    using entry_t = std::pair<double, int>;
+
+private:
+    std::vector<int> _path;
+    std::vector<double> _cost;
+    std::vector<double> _priority;
+
+    // A vertex's state is valid only if stamped with the current generation
+    std::vector<unsigned> _stamp;
+    unsigned _generation = 0;
+
+    // Lazy-deletion binary min-heap of (priority, vertex) entries
+    std::vector<entry_t> _queue;
+
+public:
+    explicit SearchContext(const Snapshot& snap);
+    explicit SearchContext(std::size_t size);
+
+    std::size_t size() const;
+
+    void reset(int source);
+
+    bool is_current(int v) const;
+    void touch(int v);
+
+    bool reached(int v) const;
+    void set_path(int v, int previous);
+    void set_cost(int v, double cost);
+    void set_priority(int v, double priority);
+
+    int get_path(int v) const;
+    double get_cost(int v) const;
+    double get_priority(int v) const;
+
+    bool empty() const;
+    void push(int v, double priority);
+    entry_t top() const;
+    entry_t pop();
+    bool stale(const entry_t& entry) const;
+    bool skip_stale();
+};
+
+inline bool SearchContext::is_current(int v) const {
+    return _stamp[v] == _generation;
+}
+
+inline void SearchContext::touch(int v) {
+    if (!is_current(v)) {
+        _stamp[v] = _generation;
+        _path[v] = -1;
+        _cost[v] = 0;
+        _priority[v] = 0;
+    }
+}
+
+inline bool SearchContext::reached(int v) const {
+    return is_current(v) && _path[v] != -1;
+}
+
+inline void SearchContext::set_path(int v, int previous) {
+    touch(v);
+    _path[v] = previous;
+}
+
+inline void SearchContext::set_cost(int v, double cost) {
+    touch(v);
+    _cost[v] = cost;
+}
+
+inline void SearchContext::set_priority(int v, double priority) {
+    touch(v);
+    _priority[v] = priority;
+}
+
+inline int SearchContext::get_path(int v) const {
+    return is_current(v) ? _path[v] : -1;
+}
+
+inline double SearchContext::get_cost(int v) const {
+    return is_current(v) ? _cost[v] : 0;
+}
+
+inline double SearchContext::get_priority(int v) const {
+    return is_current(v) ? _priority[v] : 0;
+}
+
+/**
+ * An entry is stale if its vertex was pushed again with a smaller priority.
+ */
+inline bool SearchContext::stale(const entry_t& entry) const {
+    return entry.first > _priority[entry.second];
+}
+
+inline bool SearchContext::empty() const {
+    return _queue.empty();
+}
+
+inline void SearchContext::push(int v, double priority) {
+    set_priority(v, priority);
+    _queue.push_back({priority, v});
+    std::push_heap(_queue.begin(), _queue.end(), std::greater<entry_t>());
+}
+
+inline SearchContext::entry_t SearchContext::top() const {
+    return _queue.front();
+}
+
+inline SearchContext::entry_t SearchContext::pop() {
+    std::pop_heap(_queue.begin(), _queue.end(), std::greater<entry_t>());
+    entry_t entry = _queue.back();
+    _queue.pop_back();
+    return entry;
+}
+
+/**
+ * Drops the stale entries at the top of the queue. False if the queue runs
+ * out, otherwise top() is current.
+ */
+inline bool SearchContext::skip_stale() {
+    while (!empty()) {
+        if (!stale(top())) return true;
+        pop();
+    }
+    return false;
+}
+
+#endif // SEARCH_CONTEXT_H___
@@ -0,0 +1,297 @@
+#ifndef SEARCH_KERNEL_H___
+#define SEARCH_KERNEL_H___
+
+#include "graph.h"
+#include "snapshot.h"
+#include "search_context.h"
+#include "landmarks.h"
+#include "generator.h"
+
+#include <limits>
+#include <type_traits>
+
+/**
+ * The best-first search loop shared by GBFS, both Dijkstras, A* and their
+ * relatives, once for the pointer-based graph and once for the snapshot.
+ * The variants differ only in their policies, all resolved at compile time:
+ *
+ *   Cost       the cost of an edge                      length, weight,
+ *                                                       quantised
+ *   Heuristic  the estimate from a vertex to the target zero, euclidean,
+ *              (greedy ones rank by it alone and reach  inflated,
+ *              every vertex once, without relaxing;     landmark_bound,
+ *              pruning ones never queue a vertex whose  greedy_by<...>
+ *              estimate is infinite)
+ *   Exit       whether to stop on a settled vertex      at_target, never
+ *   Visitor    called on every settled vertex           nothing
+ *
+ * Every policy is a small function object with an overload for each graph
+ * it applies to, so the kernel inlines them into a loop with no calls and
+ * no branches on the variant. A new variant is a call to search() with its
+ * policies. Exits and visitors are often lambdas over the caller's state.
+ *
+ * The snapshot search runs on the context's own heap, or on any queue with
+ * the same push(v, key), pop(), empty() and clear(): the integer queues of
+ * bucket_queue.h, or an IndexedHeap.
+ *
+ * search_steps() is the snapshot search as a coroutine, for callers that
+ * want to watch or steer it as it goes.
+ */
+
+namespace paths {
+
+namespace policy {
+
+// ***** Cost
+
+struct length {
+    double operator()(const Edge* edge) const { return edge->length(); }
+    double operator()(const Snapshot& snap, int e) const { return snap.length(e); }
+};
+
+struct weight {
+    double operator()(const Edge* edge) const { return edge->get_weight(); }
+    double operator()(const Snapshot& snap, int e) const { return snap.weight(e); }
+};
+
+// The weight in whole metres, for the integer queues (snapshot only)
+struct quantised {
+    unsigned operator()(const Snapshot& snap, int e) const { return snap.quantised(e); }
+};
+
+// ***** Heuristic
+
+struct zero {
+    static constexpr bool greedy = false;
+    static constexpr bool prunes = false;
+    double operator()(Vertex* v, Vertex* target) const { return 0; }
+    double operator()(const Snapshot& snap, int v, int target) const { return 0; }
+};
+
+struct euclidean {
+    static constexpr bool greedy = false;
+    static constexpr bool prunes = false;
+    double operator()(Vertex* v, Vertex* target) const { return target->distance(v); }
+    double operator()(const Snapshot& snap, int v, int target) const { return snap.distance(v, target); }
+};
+
+/**
+ * Euclidean scaled by factor: weighted A*, whose paths are at most factor
+ * times longer than the shortest.
+ */
+struct inflated {
+    static constexpr bool greedy = false;
+    static constexpr bool prunes = false;
+    double factor;
+    double operator()(Vertex* v, Vertex* target) const { return factor * target->distance(v); }
+    double operator()(const Snapshot& snap, int v, int target) const {
+        return factor * snap.distance(v, target);
+    }
+};
+
+/**
+ * ALT: the landmarks' triangle inequality bound, on tables by the same
+ * cost as the search (snapshot only). Infinite for the vertices the
+ * landmarks prove cannot reach the target, which are never queued.
+ */
+struct landmark_bound {
+    static constexpr bool greedy = false;
+    static constexpr bool prunes = true;
+    const Landmarks* landmarks;
+    double operator()(const Snapshot& snap, int v, int target) const {
+        return landmarks->bound(v, target);
+    }
+};
+
+template <typename Heuristic>
+struct greedy_by : Heuristic {
+    static constexpr bool greedy = true;
+};
+
+// ***** Exit
+
+struct at_target {
+    template <typename V>
+    bool operator()(V v, V target) const { return v == target; }
+};
+
+struct never {
+    template <typename V>
+    bool operator()(V v, V target) const { return false; }
+};
+
+// ***** Visitor
+
+struct nothing {
+    template <typename V>
+    void operator()(V v) const {}
+};
+
+}
+
+/**
+ * Best-first search on the pointer-based graph, on any of the heaps of
+ * MutablePriorityQueue.h. The search state is left in the vertices.
+ */
+template <typename Queue = MutablePriorityQueue<Vertex>, typename Cost, typename Heuristic,
+          typename Exit, typename Visitor = policy::nothing>
+void search(Vertex* source, Vertex* target, Cost cost, Heuristic heuristic, Exit exit,
+            Visitor visit = Visitor()) {
+    Queue vertex_queue;
+
+    vertex_queue.insert(source);
+
+    while (!vertex_queue.empty()) {
+        Vertex* current = vertex_queue.extractMin();
+        visit(current);
+        if (exit(current, target)) break;
+
+        for (Edge* edge : current->outgoing()) {
+            Vertex* next = edge->target();
+
+            auto newcost = current->get_cost() + cost(edge);
+
+            if constexpr (Heuristic::greedy) {
+                if (next->get_path() != nullptr) continue;
+
+                next->set_cost(newcost);
+                next->set_priority(heuristic(next, target));
+                next->set_path(current);
+                vertex_queue.insert(next);
+            } else if (next->get_path() == nullptr) {
+                next->set_cost(newcost);
+                next->set_priority(newcost + heuristic(next, target));
+                next->set_path(current);
+                vertex_queue.insert(next);
+            } else if (newcost < next->get_cost()) {
+                next->set_cost(newcost);
+                next->set_priority(newcost + heuristic(next, target));
+                next->set_path(current);
+                vertex_queue.decreaseKey(next);
+            }
+        }
+    }
+}
+
+namespace detail {
+
+/**
+ * The steps of a best-first search on the snapshot, which search() and
+ * search_steps() drive: start() queues the source, settle() pops the next
+ * vertex to settle (-1 once the queue runs out), and relax() follows the
+ * outgoing edges of a settled vertex.
+ *
+ * The context records the priority every vertex was last queued with, so
+ * an entry popped with a larger key is stale, on whichever queue.
+ */
+template <typename Queue, typename Cost, typename Heuristic>
+struct kernel {
+    using key_t = typename Queue::entry_t::first_type;
+
+    const Snapshot& snap;
+    SearchContext& context;
+    Queue& queue;
+    int target;
+    Cost cost;
+    Heuristic heuristic;
+
+    void push(int v, double priority) {
+        if constexpr (std::is_same_v<Queue, SearchContext>) {
+            context.push(v, priority);
+        } else {
+            context.set_priority(v, priority);
+            queue.push(v, key_t(priority));
+        }
+    }
+
+    void start(int source) {
+        context.reset(source);
+        if constexpr (!std::is_same_v<Queue, SearchContext>) queue.clear();
+        push(source, heuristic(snap, source, target));
+    }
+
+    int settle() {
+        while (!queue.empty()) {
+            auto top = queue.pop();
+            if (!context.stale({top.first, top.second})) return top.second;
+        }
+        return -1;
+    }
+
+    void relax(int current) {
+        for (int e = snap.begin(current); e < snap.end(current); ++e) {
+            int next = snap.target(e);
+
+            auto newcost = context.get_cost(current) + cost(snap, e);
+
+            if constexpr (Heuristic::greedy) {
+                if (context.reached(next)) continue;
+            } else {
+                if (context.reached(next) && newcost >= context.get_cost(next)) continue;
+            }
+
+            double estimate = heuristic(snap, next, target);
+            if constexpr (Heuristic::prunes) {
+                if (estimate == std::numeric_limits<double>::infinity()) continue;
+            }
+
+            context.set_cost(next, newcost);
+            context.set_path(next, current);
+            push(next, Heuristic::greedy ? estimate : newcost + estimate);
+        }
+    }
+};
+
+}
+
+/**
+ * Best-first search on the snapshot, on queue. Each query resets the
+ * context and leaves its search tree there.
+ */
+template <typename Queue, typename Cost, typename Heuristic, typename Exit,
+          typename Visitor = policy::nothing>
+void search(const Snapshot& snap, SearchContext& context, Queue& queue, int source, int target,
+            Cost cost, Heuristic heuristic, Exit exit, Visitor visit = Visitor()) {
+    detail::kernel<Queue, Cost, Heuristic> kernel{snap, context, queue, target, cost, heuristic};
+    kernel.start(source);
+
+    for (int current; (current = kernel.settle()) != -1;) {
+        visit(current);
+        if (exit(current, target)) break;
+        kernel.relax(current);
+    }
+}
+
+/**
+ * Best-first search on the snapshot, on the context's own heap.
+ */
+template <typename Cost, typename Heuristic, typename Exit, typename Visitor = policy::nothing>
+void search(const Snapshot& snap, SearchContext& context, int source, int target,
+            Cost cost, Heuristic heuristic, Exit exit, Visitor visit = Visitor()) {
+    search(snap, context, context, source, target, cost, heuristic, exit, visit);
+}
+
+/**
+ * The snapshot search as a coroutine, yielding every vertex as it is
+ * settled (the exit vertex included) and suspending in between. The caller
+ * can stop at any vertex, or interleave several searches; the context holds
+ * the search tree so far at every step. snap and context must outlive the
+ * generator.
+ */
+template <typename Cost, typename Heuristic, typename Exit>
+generator<int> search_steps(const Snapshot& snap, SearchContext& context, int source, int target,
+                            Cost cost, Heuristic heuristic, Exit exit) {
+    detail::kernel<SearchContext, Cost, Heuristic> kernel{snap, context, context, target, cost,
+                                                          heuristic};
+    kernel.start(source);
+
+    for (int current; (current = kernel.settle()) != -1;) {
+        co_yield current;
+        if (exit(current, target)) break;
+        kernel.relax(current);
+    }
+}
+
+}
+
+#endif // SEARCH_KERNEL_H___
@@ -0,0 +1,90 @@
+#ifndef SLAB_H___
+#define SLAB_H___
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * Typed slab allocator. Objects are constructed back to back in large
+ * blocks, so objects allocated one after the other (the loader allocates
+ * in id order) sit next to each other in memory. Objects are never freed
+ * individually: they are all destroyed together with the slab.
+ */
+template <typename T>
+class Slab {
+private:
+    struct alignas(T) cell_t {
+        unsigned char bytes[sizeof(T)];
+    };
+
+    struct block_t {
+        std::unique_ptr<cell_t[]> cells;
+        std::size_t size, capacity;
+    };
+
+    static constexpr std::size_t min_block = 1024;
+
+    std::vector<block_t> _blocks;
+
+public:
+    Slab() = default;
+    Slab(const Slab&) = delete;
+    Slab& operator=(const Slab&) = delete;
+    ~Slab();
+
+    template <typename... Args>
+    T* create(Args&&... args);
+
+    void reserve(std::size_t n);
+    std::size_t size() const;
+};
+
+template <typename T>
+Slab<T>::~Slab() {
+    for (auto block = _blocks.rbegin(); block != _blocks.rend(); ++block) {
+        for (std::size_t i = block->size; i > 0; --i) {
+            reinterpret_cast<T*>(&block->cells[i - 1])->~T();
+        }
+    }
+}
+
+template <typename T>
+template <typename... Args>
+T* Slab<T>::create(Args&&... args) {
+    if (_blocks.empty() || _blocks.back().size == _blocks.back().capacity) {
+        _blocks.push_back({std::make_unique<cell_t[]>(min_block), 0, min_block});
+    }
+
+    block_t& block = _blocks.back();
+    T* object = new (&block.cells[block.size]) T(std::forward<Args>(args)...);
+    ++block.size;
+    return object;
+}
+
+/**
+ * Makes room for n more objects in a single block.
+ */
+template <typename T>
+void Slab<T>::reserve(std::size_t n) {
+    if (!_blocks.empty() && _blocks.back().capacity - _blocks.back().size >= n) {
+        return;
+    }
+
+    if (n > min_block) {
+        _blocks.push_back({std::make_unique<cell_t[]>(n), 0, n});
+    }
+}
+
+template <typename T>
+std::size_t Slab<T>::size() const {
+    std::size_t accumulator = 0;
+    for (const block_t& block : _blocks) {
+        accumulator += block.size;
+    }
+    return accumulator;
+}
+
+#endif // SLAB_H___
@@ -0,0 +1,77 @@
+#include "snapshot.h"
+
+#include <algorithm>
+
+Snapshot::Snapshot(const Graph& graph): _scale(graph._scale) {
+    // Snapshot vertex indices are the graph's storage indices.
+    _vertices.assign(graph.V.begin(), graph.V.end());
+
+    std::size_t n = _vertices.size();
+    _xs.resize(n);
+    _ys.resize(n);
+
+    for (std::size_t v = 0; v < n; ++v) {
+        _xs[v] = _vertices[v]->x();
+        _ys[v] = _vertices[v]->y();
+    }
+
+    // Lay out the clear outgoing edges of each vertex contiguously.
+    _offsets.reserve(n + 1);
+    _offsets.push_back(0);
+
+    for (std::size_t v = 0; v < n; ++v) {
+        for (Edge* edge : _vertices[v]->outgoing()) {
+            _targets.push_back(edge->target()->index());
+            _lengths.push_back(edge->length());
+            _weights.push_back(edge->get_weight());
+            _edges.push_back(edge);
+        }
+        _offsets.push_back(_targets.size());
+    }
+
+    _quantised.reserve(_weights.size());
+    for (double weight : _weights) {
+        _quantised.push_back(std::lround(weight));
+        _max_quantised = std::max(_max_quantised, _quantised.back());
+    }
+
+    // And the clear incoming edges, from Vertex::incident().
+    _in_offsets.reserve(n + 1);
+    _in_offsets.push_back(0);
+
+    for (std::size_t v = 0; v < n; ++v) {
+        for (Edge* edge : _vertices[v]->incident()) {
+            _in_sources.push_back(edge->source()->index());
+            _in_lengths.push_back(edge->length());
+            _in_weights.push_back(edge->get_weight());
+        }
+        _in_offsets.push_back(_in_sources.size());
+    }
+}
+
+std::size_t Snapshot::size() const {
+    return _vertices.size();
+}
+
+std::size_t Snapshot::edges() const {
+    return _edges.size();
+}
+
+int Snapshot::index(const Vertex* vertex) const {
+    return vertex->index();
+}
+
+Vertex* Snapshot::vertex(int v) const {
+    return _vertices[v];
+}
+
+Edge* Snapshot::edge(int e) const {
+    return _edges[e];
+}
+
+/**
+ * Heaviest edge, by its weight in whole metres.
+ */
+unsigned Snapshot::max_quantised() const {
+    return _max_quantised;
+}
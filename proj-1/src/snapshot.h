@@ -0,0 +1,123 @@
+#ifndef SNAPSHOT_H___
+#define SNAPSHOT_H___
+
+#include "graph.h"
+
+#include <cmath>
+#include <vector>
+
+/**
+ * Immutable compressed-sparse-row snapshot of the clear edges of a Graph.
+ *
+ * Vertices are numbered 0..size()-1 by their storage index and the
+ * outgoing edges of vertex u occupy the slots begin(u)..end(u)-1 of the
+ * flat target, length and weight arrays. The incoming edges of v are laid
+ * out the same way in in_begin(v)..in_end(v)-1, for backward searches. The
+ * pointer-based graph is only touched while building; queries never leave
+ * these arrays.
+ *
+ * Built through Graph::snapshot(), which rebuilds it lazily after the
+ * edge set or the weights change. A snapshot handed out before stays
+ * valid for as long as it is held.
+ */
+class Snapshot {
+private:
+    std::vector<int> _offsets;
+    std::vector<int> _targets;
+    std::vector<double> _lengths;
+    std::vector<double> _weights;
+
+    // Weights rounded to whole metres, for the integer queues
+    std::vector<unsigned> _quantised;
+    unsigned _max_quantised = 0;
+
+    std::vector<int> _in_offsets;
+    std::vector<int> _in_sources;
+    std::vector<double> _in_lengths;
+    std::vector<double> _in_weights;
+
+    std::vector<int> _xs, _ys;
+    double _scale;
+
+    std::vector<Vertex*> _vertices;
+    std::vector<Edge*> _edges;
+
+public:
+    explicit Snapshot(const Graph& graph);
+
+    std::size_t size() const;
+    std::size_t edges() const;
+
+    int index(const Vertex* vertex) const;
+    Vertex* vertex(int v) const;
+    Edge* edge(int e) const;
+
+    // Hot accessors, inlined below
+    int begin(int v) const;
+    int end(int v) const;
+    int target(int e) const;
+    double length(int e) const;
+    double weight(int e) const;
+    unsigned quantised(int e) const;
+    double distance(int u, int v) const;
+
+    unsigned max_quantised() const;
+
+    int in_begin(int v) const;
+    int in_end(int v) const;
+    int in_source(int e) const;
+    double in_length(int e) const;
+    double in_weight(int e) const;
+};
+
+inline int Snapshot::begin(int v) const {
+    return _offsets[v];
+}
+
+inline int Snapshot::end(int v) const {
+    return _offsets[v + 1];
+}
+
+inline int Snapshot::target(int e) const {
+    return _targets[e];
+}
+
+inline double Snapshot::length(int e) const {
+    return _lengths[e];
+}
+
+inline double Snapshot::weight(int e) const {
+    return _weights[e];
+}
+
+inline unsigned Snapshot::quantised(int e) const {
+    return _quantised[e];
+}
+
+inline double Snapshot::distance(int u, int v) const {
+    double dx = _xs[u] - _xs[v];
+    double dy = _ys[u] - _ys[v];
+    return _scale * std::hypot(dx, dy);
+}
+
+inline int Snapshot::in_begin(int v) const {
+    return _in_offsets[v];
+}
+
+inline int Snapshot::in_end(int v) const {
+    return _in_offsets[v + 1];
+}
+
+inline int Snapshot::in_source(int e) const {
+    return _in_sources[e];
+}
+
+inline double Snapshot::in_length(int e) const {
+    return _in_lengths[e];
+}
+
+inline double Snapshot::in_weight(int e) const {
+    return _in_weights[e];
+}
+
+#endif // SNAPSHOT_H___
@@ -0,0 +1,146 @@
+#include "spatial.h"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <utility>
+
+// Aim for this many vertices per cell on average
+#define SPATIAL_CELL_LOAD 4.0
+
+SpatialGrid::SpatialGrid(const Graph& graph): _scale(graph._scale) {
+    std::size_t n = std::max<std::size_t>(graph.V.size(), 1);
+    double area = (double)(graph._width + 1) * (graph._height + 1);
+
+    _cell = std::max(1, (int)std::ceil(std::sqrt(area * SPATIAL_CELL_LOAD / n)));
+    _cols = graph._width / _cell + 1;
+    _rows = graph._height / _cell + 1;
+
+    // Counting sort of the vertices by cell.
+    std::vector<int> cells(graph.V.size());
+    _cell_start.assign(_cols * _rows + 1, 0);
+
+    for (std::size_t i = 0; i < graph.V.size(); ++i) {
+        Vertex* vertex = graph.V[i];
+        cells[i] = cell_row(vertex->y()) * _cols + cell_col(vertex->x());
+        ++_cell_start[cells[i] + 1];
+    }
+
+    for (std::size_t c = 1; c < _cell_start.size(); ++c) {
+        _cell_start[c] += _cell_start[c - 1];
+    }
+
+    std::vector<int> fill(_cell_start.begin(), _cell_start.end() - 1);
+    _points.resize(graph.V.size());
+
+    for (std::size_t i = 0; i < graph.V.size(); ++i) {
+        Vertex* vertex = graph.V[i];
+        _points[fill[cells[i]]++] = {vertex->x(), vertex->y(), vertex};
+    }
+}
+
+// Clamp before converting, the point may be far outside the map.
+int SpatialGrid::cell_col(double x) const {
+    return (int)std::min(std::max(std::floor(x / _cell), 0.0), (double)(_cols - 1));
+}
+
+int SpatialGrid::cell_row(double y) const {
+    return (int)std::min(std::max(std::floor(y / _cell), 0.0), (double)(_rows - 1));
+}
+
+/**
+ * The vertex closest to (x, y), nullptr if the graph is empty.
+ */
+Vertex* SpatialGrid::nearest(double x, double y) const {
+    std::vector<Vertex*> found = nearest(x, y, 1);
+    return found.empty() ? nullptr : found.front();
+}
+
+/**
+ * The k vertices closest to (x, y), closest first.
+ *
+ * Scans rings of cells around the point's cell, and stops once the
+ * distance to the outside of the scanned block exceeds the k-th best
+ * distance found so far.
+ */
+std::vector<Vertex*> SpatialGrid::nearest(double x, double y, std::size_t k) const {
+    using candidate_t = std::pair<double, Vertex*>;
+    std::priority_queue<candidate_t> best; // max-heap of the k best
+
+    if (k == 0) return {};
+
+    int col = cell_col(x), row = cell_row(y);
+    int max_ring = std::max(_cols, _rows);
+
+    for (int ring = 0; ring <= max_ring; ++ring) {
+        for (int r = row - ring; r <= row + ring; ++r) {
+            if (r < 0 || r >= _rows) continue;
+
+            // Only the border of the block is new in this ring.
+            bool border_row = (r == row - ring || r == row + ring);
+            int step = border_row ? 1 : 2 * ring;
+
+            for (int c = col - ring; c <= col + ring; c += std::max(step, 1)) {
+                if (c < 0 || c >= _cols) continue;
+
+                int cell = r * _cols + c;
+                for (int i = _cell_start[cell]; i < _cell_start[cell + 1]; ++i) {
+                    double dx = _points[i].x - x, dy = _points[i].y - y;
+                    double distance2 = dx * dx + dy * dy;
+
+                    if (best.size() < k) {
+                        best.push({distance2, _points[i].vertex});
+                    } else if (distance2 < best.top().first) {
+                        best.pop();
+                        best.push({distance2, _points[i].vertex});
+                    }
+                }
+            }
+        }
+
+        if (best.size() == k) {
+            // Any point outside the block is at least this far away.
+            double bound = std::min({
+                x - (double)(col - ring) * _cell,
+                (double)(col + ring + 1) * _cell - x,
+                y - (double)(row - ring) * _cell,
+                (double)(row + ring + 1) * _cell - y
+            });
+
+            if (bound > 0 && bound * bound >= best.top().first) break;
+        }
+    }
+
+    std::vector<Vertex*> found(best.size());
+    for (std::size_t i = found.size(); i > 0; --i) {
+        found[i - 1] = best.top().second;
+        best.pop();
+    }
+    return found;
+}
+
+/**
+ * All vertices within radius metres of (x, y), in no particular order.
+ */
+std::vector<Vertex*> SpatialGrid::within(double x, double y, double radius) const {
+    std::vector<Vertex*> found;
+    double units = radius / _scale;
+    double units2 = units * units;
+
+    int col_min = cell_col(x - units), col_max = cell_col(x + units);
+    int row_min = cell_row(y - units), row_max = cell_row(y + units);
+
+    for (int r = row_min; r <= row_max; ++r) {
+        for (int c = col_min; c <= col_max; ++c) {
+            int cell = r * _cols + c;
+            for (int i = _cell_start[cell]; i < _cell_start[cell + 1]; ++i) {
+                double dx = _points[i].x - x, dy = _points[i].y - y;
+                if (dx * dx + dy * dy <= units2) {
+                    found.push_back(_points[i].vertex);
+                }
+            }
+        }
+    }
+
+    return found;
+}
@@ -0,0 +1,42 @@
+#ifndef SPATIAL_H___
+#define SPATIAL_H___
+
+#include "graph.h"
+
+#include <vector>
+
+/**
+ * Uniform grid index over the vertex coordinates, for snapping points to
+ * the network. Built once after the map is loaded (Graph::spatial()).
+ *
+ * Queries take points in map coordinates (Vertex::x(), Vertex::y()) and
+ * distances in metres. The vertices of each cell are stored contiguously,
+ * together with their coordinates, so a query only scans the cells around
+ * the point.
+ */
+class SpatialGrid {
+private:
+    struct point_t {
+        int x, y;
+        Vertex* vertex;
+    };
+
+    int _cell;
+    int _cols, _rows;
+    double _scale;
+
+    std::vector<int> _cell_start;
+    std::vector<point_t> _points;
+
+    int cell_col(double x) const;
+    int cell_row(double y) const;
+
+public:
+    explicit SpatialGrid(const Graph& graph);
+
+    Vertex* nearest(double x, double y) const;
+    std::vector<Vertex*> nearest(double x, double y, std::size_t k) const;
+    std::vector<Vertex*> within(double x, double y, double radius) const;
+};
+
+#endif // SPATIAL_H___
@@ -0,0 +1,694 @@
+#include "test_paths.h"
+#include "paths.h"
+#include "hierarchy.h"
+#include "hublabels.h"
+#include "landmarks.h"
+#include "router.h"
+#include "idmap.h"
+#include "slab.h"
+#include "bucket_queue.h"
+#include "MutablePriorityQueue.h"
+#include "replanner.h"
+#include "reachability.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace paths;
+
+/**
+ * Checks every search against a plain textbook Dijkstra, written here
+ * independently of the searches, on random pairs of the loaded map. Each
+ * check prints one line, and test_paths() returns how many failed.
+ */
+
+static constexpr double inf = std::numeric_limits<double>::infinity();
+
+// Sums of the same edges in another order differ in the last bits, and
+// D* Lite floors every edge cost at a micrometre
+static bool same(double a, double b) {
+    if (std::isinf(a) || std::isinf(b)) return a == b;
+    return std::abs(a - b) <= 1e-3 + 1e-9 * std::abs(b);
+}
+
+namespace {
+
+struct check_t {
+    std::string name;
+    std::size_t bad = 0, total = 0;
+
+    explicit check_t(std::string name): name(std::move(name)) {}
+
+    void operator()(bool ok) {
+        bad += !ok;
+        ++total;
+    }
+};
+
+// Element of the heaps of MutablePriorityQueue.h
+struct item_t {
+    int queueIndex = 0;
+    double priority = 0;
+    double get_priority() const { return priority; }
+};
+
+}
+
+static int report(const std::vector<check_t*>& checks) {
+    int failed = 0;
+
+    for (const check_t* check : checks) {
+        std::cout << "  " << check->name << ": ";
+        if (check->bad == 0) {
+            std::cout << "ok (" << check->total << ")" << std::endl;
+        } else {
+            std::cout << "FAILED " << check->bad << " of " << check->total << std::endl;
+            ++failed;
+        }
+    }
+
+    return failed;
+}
+
+// ***** IdMap and Slab
+
+static int test_storage() {
+    check_t idmap("IdMap"), slab("Slab");
+
+    {
+        std::vector<int> items(3000);
+        IdMap<int> map;
+
+        // Dense from 1, then a negative and a far id that go sparse
+        std::vector<int> ids;
+        for (int id = 1; id <= 2500; ++id) ids.push_back(id);
+        ids.push_back(-7);
+        ids.push_back(1 << 30);
+        ids.push_back(2600);
+
+        for (std::size_t i = 0; i < ids.size(); ++i) idmap(map.insert(ids[i], &items[i]));
+        for (std::size_t i = 0; i < ids.size(); ++i) idmap(!map.insert(ids[i], &items[0]));
+        idmap(map.size() == ids.size());
+
+        for (std::size_t i = 0; i < ids.size(); ++i) {
+            idmap(map.get(ids[i]) == &items[i]);
+            idmap(map[i] == &items[i]);
+        }
+
+        idmap(map.get(0) == nullptr);
+        idmap(map.get(-8) == nullptr);
+        idmap(map.get(2501) == nullptr);
+        idmap(map.get((1 << 30) - 1) == nullptr);
+
+        std::size_t i = 0;
+        for (int* item : map) idmap(item == &items[i++]);
+        idmap(i == ids.size());
+    }
+
+    {
+        static int alive = 0;
+
+        struct counted {
+            int value;
+            explicit counted(int value): value(value) { ++alive; }
+            ~counted() { --alive; }
+        };
+
+        {
+            Slab<counted> objects;
+            std::vector<counted*> created;
+
+            objects.reserve(1500);
+            for (int i = 0; i < 5000; ++i) created.push_back(objects.create(i));
+
+            slab(objects.size() == 5000);
+            slab(alive == 5000);
+
+            // Reserved and allocated in order, so the first ones are adjacent
+            for (int i = 0; i + 1 < 1500; ++i) slab(created[i] + 1 == created[i + 1]);
+            for (int i = 0; i < 5000; ++i) slab(created[i]->value == i);
+        }
+
+        slab(alive == 0);
+    }
+
+    return report({&idmap, &slab});
+}
+
+// ***** Reference
+
+static double edge_length(const Snapshot& snap, int e) {
+    return snap.length(e);
+}
+
+static double edge_weight(const Snapshot& snap, int e) {
+    return snap.weight(e);
+}
+
+static double edge_quantised(const Snapshot& snap, int e) {
+    return snap.quantised(e);
+}
+
+/**
+ * Distances from source to every vertex, by cost.
+ */
+template <typename Cost>
+static std::vector<double> reference(const Snapshot& snap, int source, Cost cost) {
+    using entry_t = std::pair<double, int>;
+
+    std::vector<double> dist(snap.size(), inf);
+    std::priority_queue<entry_t, std::vector<entry_t>, std::greater<entry_t>> queue;
+
+    dist[source] = 0;
+    queue.push({0, source});
+
+    while (!queue.empty()) {
+        auto [d, u] = queue.top();
+        queue.pop();
+        if (d > dist[u]) continue;
+
+        for (int e = snap.begin(u); e < snap.end(u); ++e) {
+            double next = d + cost(snap, e);
+            if (next < dist[snap.target(e)]) {
+                dist[snap.target(e)] = next;
+                queue.push({next, snap.target(e)});
+            }
+        }
+    }
+
+    return dist;
+}
+
+static double cost_of(const SearchContext& context, int v) {
+    return context.reached(v) ? context.get_cost(v) : inf;
+}
+
+static double meet_cost(const SearchContext& forward, const SearchContext& backward, int meet) {
+    return meet == -1 ? inf : forward.get_cost(meet) + backward.get_cost(meet);
+}
+
+/**
+ * A path from source to target along edges of the graph, empty exactly
+ * when there is none.
+ */
+static bool valid_path(const path_t& path, Vertex* source, Vertex* target, double cost) {
+    if (path.empty()) return std::isinf(cost);
+    if (path.front() != source || path.back() != target) return false;
+
+    for (std::size_t i = 0; i + 1 < path.size(); ++i) {
+        if (!path[i]->connects_to(path[i + 1])) return false;
+    }
+    return true;
+}
+
+// ***** Queues
+
+/**
+ * Random pushes and pops on a monotone integer queue, against a multiset:
+ * every pop returns the smallest key queued, with a vertex queued under it.
+ * Keys are pushed at most range past the last key popped, equal ones
+ * included, and the queue is cleared and reused between rounds.
+ */
+template <typename Queue>
+static void check_integer_queue(Queue& queue, unsigned range, std::mt19937& rng, check_t& check) {
+    std::multiset<std::pair<unsigned, int>> expected;
+    std::uniform_int_distribution<unsigned> step(0, range);
+    std::uniform_int_distribution<int> vertex(0, 1000), coin(0, 2);
+
+    auto pop = [&]() {
+        auto entry = queue.pop();
+        auto it = expected.find(entry);
+        check(it != expected.end() && entry.first == expected.begin()->first);
+        if (it != expected.end()) expected.erase(it);
+        return entry.first;
+    };
+
+    for (int round = 0; round < 4; ++round) {
+        queue.clear();
+        expected.clear();
+        unsigned last = 0;
+
+        for (int op = 0; op < 20000; ++op) {
+            if (expected.empty() || coin(rng) != 0) {
+                unsigned key = last + step(rng);
+                int v = vertex(rng);
+                queue.push(v, key);
+                expected.insert({key, v});
+            } else {
+                last = pop();
+            }
+            check(queue.empty() == expected.empty());
+        }
+
+        // Leave some behind for clear() on odd rounds
+        while (round % 2 == 0 && !expected.empty()) pop();
+        check(queue.empty() == expected.empty());
+    }
+}
+
+/**
+ * Random inserts, decreaseKeys and extractMins on a heap of
+ * MutablePriorityQueue.h, against a set: every extractMin returns a queued
+ * item of the smallest priority. Priorities are small integers, so there
+ * are plenty of ties, and items are inserted again once extracted.
+ */
+template <typename Heap>
+static void check_mutable_heap(std::mt19937& rng, check_t& check) {
+    std::vector<item_t> items(2000);
+    std::vector<char> queued(items.size(), 0);
+    std::set<std::pair<double, int>> expected;
+    std::uniform_int_distribution<int> item(0, items.size() - 1), priority(0, 500), op(0, 3);
+
+    Heap heap;
+
+    for (int i = 0; i < 40000; ++i) {
+        int x = item(rng);
+
+        if (op(rng) == 0 && !heap.empty()) {
+            item_t* min = heap.extractMin();
+            int id = min - items.data();
+            check(queued[id] && min->priority == expected.begin()->first);
+            expected.erase({min->priority, id});
+            queued[id] = 0;
+        } else if (!queued[x]) {
+            items[x].priority = priority(rng);
+            heap.insert(&items[x]);
+            expected.insert({items[x].priority, x});
+            queued[x] = 1;
+        } else {
+            expected.erase({items[x].priority, x});
+            items[x].priority -= priority(rng) / 10;
+            heap.decreaseKey(&items[x]);
+            expected.insert({items[x].priority, x});
+        }
+        check(heap.empty() == expected.empty());
+    }
+
+    while (!heap.empty()) {
+        item_t* min = heap.extractMin();
+        check(min->priority == expected.begin()->first);
+        expected.erase({min->priority, int(min - items.data())});
+    }
+    check(expected.empty());
+}
+
+/**
+ * Random pushes (inserts and decreases) and pops on an IndexedHeap, against
+ * a set: contains() and key() follow every id, top() and pop() return a
+ * queued id of the smallest key (any of them on ties), and a cleared heap
+ * holds nothing.
+ */
+static void check_indexed_heap(std::mt19937& rng, check_t& check) {
+    IndexedHeap<> heap(2000);
+    std::vector<double> keys(heap.size());
+    std::set<std::pair<double, int>> expected;
+    std::uniform_int_distribution<int> id(0, heap.size() - 1), key(0, 500), op(0, 3);
+
+    for (int round = 0; round < 4; ++round) {
+        heap.clear();
+        expected.clear();
+
+        for (int i = 0; i < 20000; ++i) {
+            int x = id(rng);
+
+            if (op(rng) == 0 && !heap.empty()) {
+                auto top = heap.top();
+                auto entry = heap.pop();
+                check(top == entry && entry.first == expected.begin()->first);
+                check(expected.erase(entry) == 1 && !heap.contains(entry.second));
+            } else if (!heap.contains(x)) {
+                keys[x] = key(rng);
+                heap.push(x, keys[x]);
+                expected.insert({keys[x], x});
+            } else {
+                expected.erase({keys[x], x});
+                keys[x] -= key(rng) / 10;
+                heap.push(x, keys[x]);
+                expected.insert({keys[x], x});
+            }
+
+            check(heap.contains(x) == (expected.count({keys[x], x}) > 0));
+            check(!heap.contains(x) || heap.key(x) == keys[x]);
+            check(heap.empty() == expected.empty());
+        }
+
+        // Leave some behind for clear() on odd rounds
+        while (round % 2 == 0 && !heap.empty()) {
+            auto entry = heap.pop();
+            check(entry.first == expected.begin()->first && expected.erase(entry) == 1);
+        }
+        check(heap.empty() == expected.empty());
+    }
+
+    heap.clear();
+    check(heap.empty() && heap.size() == keys.size());
+    for (std::size_t x = 0; x < heap.size(); ++x) check(!heap.contains(x));
+}
+
+static int test_queues(std::mt19937& rng) {
+    check_t mutable_heaps("d-ary heaps of arity 2, 4 and 8, pairing heap");
+    check_t indexed("Indexed heap");
+    check_t integer("Radix heap and Dial's buckets");
+
+    check_mutable_heap<DaryHeap<item_t, 2>>(rng, mutable_heaps);
+    check_mutable_heap<DaryHeap<item_t, 4>>(rng, mutable_heaps);
+    check_mutable_heap<DaryHeap<item_t, 8>>(rng, mutable_heaps);
+    check_mutable_heap<PairingHeap<item_t>>(rng, mutable_heaps);
+    check_indexed_heap(rng, indexed);
+
+    auto current = graph->snapshot();
+    const Snapshot& snap = *current;
+    RadixHeap radix(snap);
+    BucketQueue dial(snap);
+
+    check_integer_queue(radix, snap.max_quantised(), rng, integer);
+    check_integer_queue(dial, snap.max_quantised(), rng, integer);
+    check_integer_queue(radix, 1000000, rng, integer);
+
+    return report({&mutable_heaps, &indexed, &integer});
+}
+
+// ***** Searches
+
+static int test_searches(std::size_t pairs, std::mt19937& rng) {
+    check_t pointer("Dijkstra on every heap, A* and weighted Dijkstra (pointers)");
+    check_t snapshot("BFS, GBFS, Dijkstra, A* and weighted Dijkstra (snapshot)");
+    check_t weighted("Weighted A* within its factor (snapshot)");
+    check_t steps("Dijkstra and A* steps");
+    check_t indexed("Dijkstra on IndexedHeap");
+    check_t quantised("Quantised Dijkstra, radix heap and Dial's buckets");
+    check_t bidirectional("Bidirectional Dijkstra and A*");
+    check_t hierarchy("Contraction Hierarchy");
+    check_t alt("ALT, by length and by weight");
+    check_t labels("Hub labels");
+    check_t isochrones("Isochrones, by length and by weight");
+    check_t tables("Distance tables, plain and CH");
+    check_t router("Batch router, every engine");
+
+    auto current = graph->snapshot();
+    const Snapshot& snap = *current;
+    const ContractionHierarchy& ch = graph->hierarchy();
+    const Landmarks& landmarks = graph->landmarks();
+    Landmarks landmarks_weight(snap, LANDMARKS_DEFAULT_COUNT, Landmarks::selection::avoid,
+                               Landmarks::metric::weight);
+    HubLabels hub_labels(snap, ch, true);
+
+    SearchContext context(snap), backward(snap);
+    IndexedHeap<> heap(snap.size());
+    RadixHeap radix(snap);
+    BucketQueue dial(snap);
+
+    std::uniform_int_distribution<int> vertex(0, snap.size() - 1);
+    std::vector<query_t> queries;
+    std::vector<double> expected;
+
+    for (std::size_t i = 0; i < pairs; ++i) {
+        int s = vertex(rng), t = vertex(rng);
+        if (i % 10 == 0) t = s;
+
+        Vertex* source = snap.vertex(s);
+        Vertex* target = snap.vertex(t);
+
+        auto by_length = reference(snap, s, edge_length);
+        auto by_weight = reference(snap, s, edge_weight);
+        auto by_quantised = reference(snap, s, edge_quantised);
+
+        double d = by_length[t], w = by_weight[t];
+        queries.push_back({s, t});
+        expected.push_back(d);
+
+        // Pointer-based graph
+        if (s != t) {
+            auto pointer_cost = [&]() { return target->get_path() ? target->get_cost() : inf; };
+
+            graph->clear();
+            dijkstra_early_exit(source, target);
+            pointer(same(pointer_cost(), d));
+            pointer(valid_path(get_path(source, target), source, target, d));
+
+            graph->clear();
+            dijkstra_early_exit<DaryHeap<Vertex, 2>>(source, target);
+            pointer(same(pointer_cost(), d));
+
+            graph->clear();
+            dijkstra_early_exit<DaryHeap<Vertex, 4>>(source, target);
+            pointer(same(pointer_cost(), d));
+
+            graph->clear();
+            dijkstra_early_exit<PairingHeap<Vertex>>(source, target);
+            pointer(same(pointer_cost(), d));
+
+            graph->clear();
+            astar_search(source, target);
+            pointer(same(pointer_cost(), d));
+
+            graph->clear();
+            dijkstra_weight(source, target);
+            pointer(same(pointer_cost(), w));
+        }
+
+        // Snapshot
+        breadth_first_search(snap, context, s);
+        for (std::size_t v = 0; v < snap.size(); ++v) {
+            snapshot(context.reached(v) == !std::isinf(by_length[v]));
+        }
+
+        greedy_best_first_search(snap, context, s, t);
+        snapshot(valid_path(get_path(snap, context, s, t), source, target, d));
+
+        dijkstra_early_exit(snap, context, s, t);
+        snapshot(same(cost_of(context, t), d));
+        snapshot(valid_path(get_path(snap, context, s, t), source, target, d));
+
+        dijkstra_late_exit(snap, context, s, t);
+        for (std::size_t v = 0; v < snap.size(); ++v) snapshot(same(cost_of(context, v), by_length[v]));
+
+        astar_search(snap, context, s, t);
+        snapshot(same(cost_of(context, t), d));
+
+        dijkstra_weight(snap, context, s, t);
+        snapshot(same(cost_of(context, t), w));
+
+        weighted_astar(snap, context, s, t, 1.5);
+        weighted(std::isinf(d) ? !context.reached(t) : cost_of(context, t) <= 1.5 * d + 1e-3);
+
+        int settled = -1;
+        for (int v : dijkstra_steps(snap, context, s, t)) settled = v;
+        steps(std::isinf(d) ? settled != t : settled == t && same(cost_of(context, t), d));
+        settled = -1;
+        for (int v : astar_steps(snap, context, s, t)) settled = v;
+        steps(std::isinf(d) ? settled != t : settled == t && same(cost_of(context, t), d));
+
+        dijkstra_indexed(snap, context, heap, s, t);
+        indexed(same(cost_of(context, t), d));
+        indexed(heap.size() == snap.size());
+
+        dijkstra_quantised(snap, context, radix, s, t);
+        quantised(same(cost_of(context, t), by_quantised[t]));
+        dijkstra_quantised(snap, context, dial, s, t);
+        quantised(same(cost_of(context, t), by_quantised[t]));
+
+        int meet = bidirectional_dijkstra(snap, context, backward, s, t);
+        bidirectional(same(meet_cost(context, backward, meet), d));
+        bidirectional(valid_path(get_path(snap, context, backward, s, t, meet), source, target, d));
+        meet = bidirectional_astar(snap, context, backward, s, t);
+        bidirectional(same(meet_cost(context, backward, meet), d));
+
+        meet = ch.search(context, backward, s, t);
+        hierarchy(same(meet_cost(context, backward, meet), d));
+        hierarchy(valid_path(ch.get_path(context, backward, s, t, meet), source, target, d));
+
+        astar_landmarks(snap, context, landmarks, s, t);
+        alt(same(cost_of(context, t), d));
+        astar_landmarks_weight(snap, context, landmarks_weight, s, t);
+        alt(same(cost_of(context, t), w));
+        for (int k = 0; k < 2; ++k) {
+            int v = vertex(rng);
+            alt(landmarks.bound(v, t) <= reference(snap, v, edge_length)[t] + 1e-6);
+        }
+
+        labels(same(hub_labels.distance(s, t), d));
+        labels(valid_path(hub_labels.get_path(s, t), source, target, d));
+
+        // The distance to the target, which puts it on the edge of the region, and a short walk
+        for (double budget : {std::isinf(d) ? 1000.0 : d, 300.0}) {
+            isochrone_t region;
+            std::vector<char> listed(snap.edges(), 0);
+
+            isochrone(snap, context, s, budget, region);
+            for (int v : region.vertices) {
+                isochrones(by_length[v] <= budget && same(context.get_cost(v), by_length[v]));
+            }
+            for (int e : region.boundary) listed[e] = 1;
+
+            std::size_t within = 0;
+            for (double cost : by_length) within += cost <= budget;
+            isochrones(region.vertices.size() == within);
+            for (int v : region.vertices) {
+                for (int e = snap.begin(v); e < snap.end(v); ++e) {
+                    isochrones((by_length[v] + snap.length(e) > budget) == bool(listed[e]));
+                }
+            }
+
+            isochrone<policy::weight>(snap, context, s, budget, region);
+            within = 0;
+            for (double cost : by_weight) within += cost <= budget;
+            isochrones(region.vertices.size() == within);
+            for (int v : region.vertices) isochrones(by_weight[v] <= budget);
+        }
+    }
+
+    // Distance tables on the first sources and targets, against their rows
+    std::size_t side = std::min<std::size_t>(pairs, 20);
+    std::vector<int> sources, targets;
+    for (std::size_t i = 0; i < side; ++i) {
+        sources.push_back(queries[i].first);
+        targets.push_back(queries[side - 1 - i].second);
+    }
+
+    std::vector<double> table(side * side), ch_table(side * side);
+    distance_table(snap, sources, targets, table.data(), 2);
+    ch.distance_table(sources, targets, ch_table.data(), 2);
+
+    for (std::size_t i = 0; i < side; ++i) {
+        auto row = reference(snap, sources[i], edge_length);
+        for (std::size_t j = 0; j < side; ++j) {
+            tables(same(table[i * side + j], row[targets[j]]));
+            tables(same(ch_table[i * side + j], row[targets[j]]));
+        }
+    }
+
+    // Batch router, with paths
+    using engine = BatchRouter::engine;
+    for (engine method : {engine::dijkstra, engine::astar, engine::bidirectional, engine::hierarchy}) {
+        BatchRouter batch(current, method, &ch, 2);
+        std::vector<double> costs(queries.size());
+        std::vector<path_t> routes(queries.size());
+
+        batch.route(queries, costs.data(), routes.data());
+
+        for (std::size_t i = 0; i < queries.size(); ++i) {
+            Vertex* source = snap.vertex(queries[i].first);
+            Vertex* target = snap.vertex(queries[i].second);
+            router(same(costs[i], expected[i]));
+            router(valid_path(routes[i], source, target, expected[i]));
+        }
+    }
+
+    return report({&pointer, &snapshot, &weighted, &steps, &indexed, &quantised, &bidirectional,
+                   &hierarchy, &alt, &labels, &isochrones, &tables, &router});
+}
+
+// ***** Changing graph: reachability and D* Lite
+
+/**
+ * Closes random edges and redraws the traffic a few times, checking the
+ * reachability index and a D* Lite planner against fresh searches after
+ * every change. The edges are fixed again at the end, but the weights stay
+ * redrawn.
+ */
+static int test_changes(std::size_t pairs, std::mt19937& rng) {
+    check_t reachability("Reachability after accidents");
+    check_t replanner("D* Lite after accidents and traffic");
+
+    auto current = graph->snapshot();
+    std::uniform_int_distribution<int> vertex(0, current->size() - 1);
+    SearchContext context(current->size());
+
+    std::vector<Edge*> closed;
+    std::vector<std::pair<Vertex*, DStarLite>> planners;
+    std::vector<Vertex*> starts;
+
+    for (std::size_t i = 0; i < std::min<std::size_t>(pairs, 10); ++i) {
+        Vertex* start = current->vertex(vertex(rng));
+        Vertex* goal = current->vertex(vertex(rng));
+        planners.emplace_back(goal, DStarLite(*graph, goal));
+        starts.push_back(start);
+    }
+
+    for (int round = 0; round < 6; ++round) {
+        if (round % 2 == 0) {
+            // The accidents drop the graph's snapshot, not the one held here
+            std::uniform_int_distribution<int> edge(0, current->edges() - 1);
+            for (int k = 0; k < 20; ++k) {
+                Edge* closing = current->edge(edge(rng));
+                if (closing->accident()) closed.push_back(closing);
+            }
+        } else {
+            graph->regenerate();
+        }
+
+        current = graph->snapshot();
+        const Snapshot& snap = *current;
+        const Reachability& index = graph->reachability();
+
+        for (std::size_t i = 0; i < pairs; ++i) {
+            int s = vertex(rng), t = vertex(rng);
+            breadth_first_search(snap, context, s);
+            reachability(index.reaches(snap.vertex(s), snap.vertex(t)) == context.reached(t));
+        }
+
+        for (std::size_t i = 0; i < planners.size(); ++i) {
+            auto& [goal, planner] = planners[i];
+            Vertex* start = starts[i];
+
+            planner.replan(start);
+            path_t path = planner.path();
+
+            double d = reference(snap, snap.index(start), edge_weight)[snap.index(goal)];
+            // The lightest of the parallel clear edges of every step
+            double along = 0;
+            for (std::size_t k = 0; k + 1 < path.size(); ++k) {
+                double step = inf;
+                for (Edge* edge : path[k]->outgoing()) {
+                    if (edge->target() == path[k + 1]) step = std::min(step, edge->get_weight());
+                }
+                along += step;
+            }
+
+            replanner(valid_path(path, start, goal, d));
+            replanner(path.empty() || (same(along, d) && same(planner.cost(), d)));
+        }
+    }
+
+    for (Edge* edge : closed) edge->fix();
+
+    return report({&reachability, &replanner});
+}
+
+int test_paths(std::size_t pairs) {
+    std::mt19937 rng(2021);
+    int failed = 0;
+
+    // Weights between half and twice the length, so that the weighted
+    // searches differ from the plain ones
+    auto current = graph->snapshot();
+    std::uniform_real_distribution<double> factor(0.5, 2.0);
+    for (std::size_t e = 0; e < current->edges(); ++e) {
+        Edge* edge = current->edge(e);
+        edge->set_weight(factor(rng) * edge->length());
+    }
+
+    std::cout << " **** Storage ****" << std::endl;
+    failed += test_storage();
+
+    std::cout << " **** Queues ****" << std::endl;
+    failed += test_queues(rng);
+
+    std::cout << " **** Searches (" << pairs << " random pairs) ****" << std::endl;
+    failed += test_searches(pairs, rng);
+
+    std::cout << " **** Changing graph ****" << std::endl;
+    failed += test_changes(pairs, rng);
+
+    std::cout << (failed == 0 ? " All checks passed." : " Some checks FAILED.") << std::endl;
+    return failed;
+}
@@ -0,0 +1,8 @@
+#ifndef TEST_PATHS_H___
+#define TEST_PATHS_H___
+
+#include <cstddef>
+
+int test_paths(std::size_t pairs = 200);
+
+#endif // TEST_PATHS_H___
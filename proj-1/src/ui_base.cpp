@@ -1,5 +1,7 @@
 #include "ui_base.h"
 #include "paths.h"
+#include "spatial.h"
+#include "reachability.h"
 #include "benchmark.h"
 
 #include <limits>
@@ -25,6 +27,26 @@ static int get_numeric_input(const std::string& input, int max = -1) {
     }
 }
 
+static const std::regex regex_point(R"Z(\s*(\d{1,8})\s*[ ,;]\s*(\d{1,8})\s*)Z");
+
+static bool get_point_input(const std::string& input) {
+    return std::regex_match(input, regex_point);
+}
+
+/**
+ * A vertex is given either by its id ("42") or by a point in map
+ * coordinates ("120 45" or "120,45"), which snaps to the nearest vertex.
+ */
+static Vertex* get_vertex_input(const std::string& input) {
+    std::smatch match;
+
+    if (std::regex_match(input, match, regex_point)) {
+        return graph->spatial().nearest(std::stoi(match[1]), std::stoi(match[2]));
+    } else {
+        return graph->get_vertex(std::stoi(input));
+    }
+}
+
 #ifdef _WIN32
     #include <cstdlib>
 
@@ -77,12 +99,11 @@ Vertex* select_vertex(bool may_be_accidented) {
 
     while (true) {
         std::string input;
-        std::cout << "Select vertex (q to quit): ";
+        std::cout << "Select vertex (id or x,y; q to quit): ";
         std::getline(std::cin, input);
 
-        if (get_numeric_input(input)) {
-            int id = std::stoi(input);
-            Vertex* vertex = graph->get_vertex(id);
+        if (get_numeric_input(input) || get_point_input(input)) {
+            Vertex* vertex = get_vertex_input(input);
 
             if (vertex != nullptr) { // Vertex found
                 if (!may_be_accidented && vertex->is_accidented()) {
@@ -110,12 +131,11 @@ Vertex* select_source_vertex(bool may_be_accidented) {
 
     while (true) {
         std::string input;
-        std::cout << "Select source vertex (q to quit): ";
+        std::cout << "Select source vertex (id or x,y; q to quit): ";
         std::getline(std::cin, input);
 
-        if (get_numeric_input(input)) {
-            int id = std::stoi(input);
-            Vertex* vertex = graph->get_vertex(id);
+        if (get_numeric_input(input) || get_point_input(input)) {
+            Vertex* vertex = get_vertex_input(input);
 
             if (vertex != nullptr) { // Vertex found
                 if (!may_be_accidented && vertex->is_accidented()) {
@@ -143,21 +163,18 @@ Vertex* select_target_vertex(Vertex* source, bool may_be_accidented, bool must_b
     graph->show_all_vertex_ids();
     Vertex* selected;
 
-    if (must_be_reachable) paths::breadth_first_search(source);
-
     while (true) {
         std::string input;
-        std::cout << "Select target vertex (q to quit): ";
+        std::cout << "Select target vertex (id or x,y; q to quit): ";
         std::getline(std::cin, input);
 
-        if (get_numeric_input(input)) {
-            int id = std::stoi(input);
-            Vertex* vertex = graph->get_vertex(id);
+        if (get_numeric_input(input) || get_point_input(input)) {
+            Vertex* vertex = get_vertex_input(input);
 
             if (vertex != nullptr) { // Vertex found
                 if (!may_be_accidented && vertex->is_accidented()) {
                     std::cout << " Error: Accidented vertex." << std::endl;
-                } else if (vertex->get_path() == nullptr) {
+                } else if (must_be_reachable && !graph->reachability().reaches(source, vertex)) {
                     std::cout << " Error: Not reachable." << std::endl;
                 } else { // All goochy
                     selected = vertex;
@@ -172,8 +189,6 @@ Vertex* select_target_vertex(Vertex* source, bool may_be_accidented, bool must_b
         }
     }
 
-    if (must_be_reachable) graph->clear();
-
     graph->hide_all_vertex_ids();
     return selected;
 }
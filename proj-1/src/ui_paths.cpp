@@ -1,14 +1,25 @@
 #include "ui_paths.h"
 #include "paths.h"
 #include "benchmark.h"
+#include "replanner.h"
+#include "hierarchy.h"
+#include "hublabels.h"
+#include "router.h"
 
+#include <algorithm>
 #include <limits>
 #include <iostream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #define UPDATE_SPEED_1 200.0
 #define UPDATE_SPEED_2 100.0
+#define STEP_BATCH 32
+
+// Sources and targets of the benchmark's distance tables
+#define TABLE_SIZE 100
+#define ROUTER_BATCH 1000
 
 namespace ui {
 
@@ -19,10 +30,16 @@ static const std::string ui_string = "$ Shortest Path Algorithms\n"
     " 2 - Dijkstra Late Exit\n"
     " 3 - Dijkstra Early Exit\n"
     " 4 - A*\n"
-    " 5 - Simulation (edge by edge)\n"
-    " 6 - Simulation (road by road)\n"
-    " 7 - Benchmark GBFS, Dijkstra and A*\n"
-    " 8 < return\n";
+    " 5 - Bidirectional Dijkstra\n"
+    " 6 - Bidirectional A*\n"
+    " 7 - Contraction Hierarchies\n"
+    " 8 - A* with landmarks (ALT)\n"
+    " 9 - Isochrone (as far as the target)\n"
+    "10 - A* step by step\n"
+    "11 - Simulation (edge by edge)\n"
+    "12 - Simulation (road by road)\n"
+    "13 - Benchmark GBFS, Dijkstra and A*\n"
+    "14 < return\n";
 
 static void animate_one_edge(path_t path, Vertex* &current) {
     graph->view_vertex_custom(current, PATH_COLOR_1);
@@ -30,8 +47,8 @@ static void animate_one_edge(path_t path, Vertex* &current) {
     // The new current is the next vertex in the path
     current = path.at(1);
 
-    path_t first = get_path(path.front(), path.at(1));
-    path_t second = get_path(path.at(1), path.back());
+    path_t first(path.begin(), path.begin() + 2);
+    path_t second(path.begin() + 1, path.end());
 
     graph->animate_path(first, 200, PATH_COLOR_1);
     graph->animate_path(second, 15, PATH_COLOR_2);
@@ -48,18 +65,19 @@ static void animate_one_road(path_t path, Vertex* &current) {
     // If the entire path is contained in one Road, i.e. this is the
     // last road and the for cycle ends naturally, then
     // the new current is the last (destination) vertex.
-    current = path.back();
+    size_t split = path.size() - 1;
     for (size_t i = 1; i < path.size(); ++i) {
         Edge* edge = path.at(i - 1)->edge_to(path.at(i));
         Road* road = edge->road();
         if (road != first_road) {
-            current = path.at(i - 1);
+            split = i - 1;
             break;
         }
     }
+    current = path.at(split);
 
-    path_t first = get_path(path.front(), current);
-    path_t second = get_path(current, path.back());
+    path_t first(path.begin(), path.begin() + split + 1);
+    path_t second(path.begin() + split, path.end());
 
     graph->animate_path(first, 200, PATH_COLOR_1);
     graph->animate_path(second, 15, PATH_COLOR_2);
@@ -136,15 +154,181 @@ void do_astar_search(Vertex* source, Vertex* target) {
     //discard();
 }
 
+/**
+ * The bidirectional searches run on the snapshot, as the search state in
+ * the vertices only holds one search.
+ */
+void do_bidirectional_dijkstra_search(Vertex* source, Vertex* target) {
+    auto current = graph->snapshot();
+    const Snapshot& snap = *current;
+    SearchContext forward(snap), backward(snap);
+    int s = snap.index(source), t = snap.index(target);
+
+    // Perform Bidirectional Dijkstra
+    int meet = bidirectional_dijkstra(snap, forward, backward, s, t);
+    path_t path = get_path(snap, forward, backward, s, t, meet);
+    graph->clear();
+
+    // Animate Bidirectional Dijkstra
+    graph->view_vertex_select(source);
+    graph->animate_path(path, UPDATE_SPEED_1, PATH_COLOR_1);
+    graph->view_vertex_select(target);
+    graph->update();
+    //discard();
+}
+
+void do_bidirectional_astar_search(Vertex* source, Vertex* target) {
+    auto current = graph->snapshot();
+    const Snapshot& snap = *current;
+    SearchContext forward(snap), backward(snap);
+    int s = snap.index(source), t = snap.index(target);
+
+    // Perform Bidirectional A*
+    int meet = bidirectional_astar(snap, forward, backward, s, t);
+    path_t path = get_path(snap, forward, backward, s, t, meet);
+    graph->clear();
+
+    // Animate Bidirectional A*
+    graph->view_vertex_select(source);
+    graph->animate_path(path, UPDATE_SPEED_1, PATH_COLOR_1);
+    graph->view_vertex_select(target);
+    graph->update();
+    //discard();
+}
+
+/**
+ * The hierarchy is preprocessed on first use, and again after accidents.
+ */
+void do_contraction_hierarchy_search(Vertex* source, Vertex* target) {
+    auto current = graph->snapshot();
+    const Snapshot& snap = *current;
+    const ContractionHierarchy& hierarchy = graph->hierarchy();
+    SearchContext forward(snap), backward(snap);
+    int s = snap.index(source), t = snap.index(target);
+
+    // Perform the hierarchy query
+    int meet = hierarchy.search(forward, backward, s, t);
+    path_t path = hierarchy.get_path(forward, backward, s, t, meet);
+    graph->clear();
+
+    // Animate the unpacked path
+    graph->view_vertex_select(source);
+    graph->animate_path(path, UPDATE_SPEED_1, PATH_COLOR_1);
+    graph->view_vertex_select(target);
+    graph->update();
+    //discard();
+}
+
+/**
+ * The landmark tables are computed on first use, and again after accidents.
+ */
+void do_astar_landmarks_search(Vertex* source, Vertex* target) {
+    auto current = graph->snapshot();
+    const Snapshot& snap = *current;
+    const Landmarks& landmarks = graph->landmarks();
+    SearchContext context(snap);
+    int s = snap.index(source), t = snap.index(target);
+
+    // Perform A* with landmarks
+    astar_landmarks(snap, context, landmarks, s, t);
+    path_t path = get_path(snap, context, s, t);
+    graph->clear();
+
+    // Animate A* with landmarks
+    graph->view_vertex_select(source);
+    graph->animate_path(path, UPDATE_SPEED_1, PATH_COLOR_1);
+    graph->view_vertex_select(target);
+    graph->update();
+    //discard();
+}
+
+/**
+ * Shows everything within the length of the shortest path to the target,
+ * and the edges where that budget runs out.
+ */
+void do_isochrone_search(Vertex* source, Vertex* target) {
+    auto current = graph->snapshot();
+    const Snapshot& snap = *current;
+    SearchContext context(snap);
+    int s = snap.index(source), t = snap.index(target);
+
+    // The budget is the distance to the target
+    dijkstra_early_exit(snap, context, s, t);
+    if (!context.reached(t)) {
+        std::cout << " Error: Not reachable." << std::endl;
+        return;
+    }
+    double budget = context.get_cost(t);
+
+    isochrone_t region;
+    isochrone(snap, context, s, budget, region);
+    graph->clear();
+
+    for (int v : region.vertices) {
+        graph->view_vertex_custom(snap.vertex(v), PATH_COLOR_1);
+    }
+    for (int e : region.boundary) {
+        graph->view_edge_custom(snap.edge(e), PATH_COLOR_3);
+    }
+
+    graph->view_vertex_select(source);
+    graph->view_vertex_select(target);
+    graph->update();
+
+    std::cout << region.vertices.size() << " vertices within " << budget << ", "
+              << region.boundary.size() << " boundary edges." << std::endl;
+    //discard();
+}
+
+/**
+ * A* as a coroutine: every vertex is shown as it is settled, a batch at a
+ * time, and the path is then taken from the same search.
+ */
+void do_astar_steps_search(Vertex* source, Vertex* target) {
+    auto current = graph->snapshot();
+    const Snapshot& snap = *current;
+    SearchContext context(snap);
+    int s = snap.index(source), t = snap.index(target);
+
+    graph->clear();
+    graph->view_vertex_select(source);
+    graph->view_vertex_select(target);
+
+    std::size_t settled = 0;
+
+    for (int v : astar_steps(snap, context, s, t)) {
+        if (v != s && v != t) graph->view_vertex_custom(snap.vertex(v), PATH_COLOR_2);
+        if (++settled % STEP_BATCH == 0) graph->update();
+    }
+    graph->update();
+
+    path_t path = get_path(snap, context, s, t);
+    graph->animate_path(path, UPDATE_SPEED_1, PATH_COLOR_1);
+    graph->view_vertex_select(target);
+    graph->update();
+
+    std::cout << settled << " vertices settled." << std::endl;
+    //discard();
+}
+
+/**
+ * The planner follows the traffic from tick to tick. A regenerate() changes
+ * every clear edge, so each replan() here is a fresh search from the
+ * target: D* Lite only repairs its tree after sparse changes.
+ */
 void do_edge_simulation(Vertex* source, Vertex* target) {
-    while (true) {
-        dijkstra_weight(source, target);
-        path_t path = get_path(source, target);
+    DStarLite planner(*graph, target);
+
+    while (source != target) {
+        planner.replan(source);
+        path_t path = planner.path();
+        if (path.empty()) break;
+
         animate_one_edge(path, source);
         if (!discard()) break;
 
         if (source == target) break;
-        path = get_path(source, target);
+        path.erase(path.begin());
         graph->clear_path(path, 0);
 
         // Simulate
@@ -153,14 +337,18 @@ void do_edge_simulation(Vertex* source, Vertex* target) {
 }
 
 void do_road_simulation(Vertex* source, Vertex* target) {
-    while (true) {
-        dijkstra_weight(source, target);
-        path_t path = get_path(source, target);
+    DStarLite planner(*graph, target);
+
+    while (source != target) {
+        planner.replan(source);
+        path_t path = planner.path();
+        if (path.empty()) break;
+
         animate_one_road(path, source);
         if (!discard()) break;
 
         if (source == target) break;
-        path = get_path(source, target);
+        path.erase(path.begin(), std::find(path.begin(), path.end(), source));
         graph->clear_path(path, 0);
 
         // Simulate
@@ -181,6 +369,7 @@ void do_benchmark(Vertex* source, Vertex* target) {
     graph->view_vertex_select(target);
 
     std::cout << "=== Benchmark " << iterations << " iterations ===\n" << std::endl;
+    std::cout << "(times include resetting the search state)\n" << std::endl;
 
     // Silent warmup, bring the relevant memory into the cache
     for (int i = 0; i < std::min(10, iterations / 10); ++i) {
@@ -201,9 +390,9 @@ void do_benchmark(Vertex* source, Vertex* target) {
         for (int i = 0; i < iterations; ++i) {
             now_t start = time_now();
             greedy_best_first_search(source, target);
+            graph->clear();
             now_t end = time_now();
             time += time_diff(start, end);
-            graph->clear();
         }
 
         auto total = time.count() / iterations;
@@ -233,9 +422,9 @@ void do_benchmark(Vertex* source, Vertex* target) {
         for (int i = 0; i < iterations; ++i) {
             now_t start = time_now();
             dijkstra_late_exit(source, target);
+            graph->clear();
             now_t end = time_now();
             time += time_diff(start, end);
-            graph->clear();
         }
 
         auto total = time.count() / iterations;
@@ -251,9 +440,9 @@ void do_benchmark(Vertex* source, Vertex* target) {
         for (int i = 0; i < iterations; ++i) {
             now_t start = time_now();
             dijkstra_early_exit(source, target);
+            graph->clear();
             now_t end = time_now();
             time += time_diff(start, end);
-            graph->clear();
         }
 
         auto total = time.count() / iterations;
@@ -269,9 +458,9 @@ void do_benchmark(Vertex* source, Vertex* target) {
         for (int i = 0; i < iterations; ++i) {
             now_t start = time_now();
             astar_search(source, target);
+            graph->clear();
             now_t end = time_now();
             time += time_diff(start, end);
-            graph->clear();
         }
 
         auto total = time.count() / iterations;
@@ -280,6 +469,434 @@ void do_benchmark(Vertex* source, Vertex* target) {
         std::cout << "Average Time: " << total << " microseconds." << std::endl;
     }
 
+    // Snapshot (CSR) searches, the snapshot is built outside the timings
+    auto current = graph->snapshot();
+    const Snapshot& snap = *current;
+    SearchContext context(snap);
+    int s = snap.index(source), t = snap.index(target);
+
+    // Benchmark Early Exit Dijkstra (snapshot)
+    {
+        micro_t time = 0us;
+
+        for (int i = 0; i < iterations; ++i) {
+            now_t start = time_now();
+            dijkstra_early_exit(snap, context, s, t);
+            now_t end = time_now();
+            time += time_diff(start, end);
+        }
+
+        auto total = time.count() / iterations;
+
+        std::cout << "--- (5) Early Exit Dijkstra (snapshot) ---" << std::endl;
+        std::cout << "Average Time: " << total << " microseconds." << std::endl;
+    }
+
+    // Benchmark A* (snapshot)
+    {
+        micro_t time = 0us;
+
+        for (int i = 0; i < iterations; ++i) {
+            now_t start = time_now();
+            astar_search(snap, context, s, t);
+            now_t end = time_now();
+            time += time_diff(start, end);
+        }
+
+        auto total = time.count() / iterations;
+
+        std::cout << "--- (6) A* Search (snapshot) ---" << std::endl;
+        std::cout << "Average Time: " << total << " microseconds." << std::endl;
+    }
+
+    SearchContext backward(snap);
+
+    // Benchmark Bidirectional Dijkstra (snapshot)
+    {
+        micro_t time = 0us;
+
+        for (int i = 0; i < iterations; ++i) {
+            now_t start = time_now();
+            bidirectional_dijkstra(snap, context, backward, s, t);
+            now_t end = time_now();
+            time += time_diff(start, end);
+        }
+
+        auto total = time.count() / iterations;
+
+        std::cout << "--- (7) Bidirectional Dijkstra (snapshot) ---" << std::endl;
+        std::cout << "Average Time: " << total << " microseconds." << std::endl;
+    }
+
+    // Benchmark Bidirectional A* (snapshot)
+    {
+        micro_t time = 0us;
+
+        for (int i = 0; i < iterations; ++i) {
+            now_t start = time_now();
+            bidirectional_astar(snap, context, backward, s, t);
+            now_t end = time_now();
+            time += time_diff(start, end);
+        }
+
+        auto total = time.count() / iterations;
+
+        std::cout << "--- (8) Bidirectional A* (snapshot) ---" << std::endl;
+        std::cout << "Average Time: " << total << " microseconds." << std::endl;
+    }
+
+    // Benchmark Contraction Hierarchies, preprocessing timed separately
+    {
+        now_t built = time_now();
+        const ContractionHierarchy& hierarchy = graph->hierarchy();
+        micro_t preprocessing = time_diff(built, time_now());
+
+        micro_t time = 0us;
+
+        for (int i = 0; i < iterations; ++i) {
+            now_t start = time_now();
+            hierarchy.search(context, backward, s, t);
+            now_t end = time_now();
+            time += time_diff(start, end);
+        }
+
+        auto total = time.count() / iterations;
+
+        std::cout << "--- (9) Contraction Hierarchies ---" << std::endl;
+        std::cout << "Preprocessing: " << preprocessing.count() << " microseconds ("
+                  << hierarchy.shortcuts() << " shortcuts)." << std::endl;
+        std::cout << "Average Time: " << total << " microseconds." << std::endl;
+    }
+
+    // Benchmark A* with landmarks, preprocessing timed separately
+    {
+        now_t built = time_now();
+        const Landmarks& landmarks = graph->landmarks();
+        micro_t preprocessing = time_diff(built, time_now());
+
+        micro_t time = 0us;
+
+        for (int i = 0; i < iterations; ++i) {
+            now_t start = time_now();
+            astar_landmarks(snap, context, landmarks, s, t);
+            now_t end = time_now();
+            time += time_diff(start, end);
+        }
+
+        auto total = time.count() / iterations;
+
+        std::cout << "--- (10) A* with landmarks (snapshot) ---" << std::endl;
+        std::cout << "Preprocessing: " << preprocessing.count() << " microseconds ("
+                  << landmarks.count() << " landmarks, " << landmarks.memory() / 1024
+                  << " KB)." << std::endl;
+        std::cout << "Average Time: " << total << " microseconds." << std::endl;
+    }
+
+    // Benchmark Weighted Dijkstra (snapshot)
+    {
+        micro_t time = 0us;
+
+        for (int i = 0; i < iterations; ++i) {
+            now_t start = time_now();
+            dijkstra_weight(snap, context, s, t);
+            now_t end = time_now();
+            time += time_diff(start, end);
+        }
+
+        auto total = time.count() / iterations;
+
+        std::cout << "--- (11) Weighted Dijkstra (snapshot) ---" << std::endl;
+        std::cout << "Average Time: " << total << " microseconds." << std::endl;
+    }
+
+    // Benchmark Weighted A* with landmarks, on tables for the current weights
+    {
+        now_t built = time_now();
+        Landmarks landmarks(snap, LANDMARKS_DEFAULT_COUNT, Landmarks::selection::avoid,
+                            Landmarks::metric::weight);
+        micro_t preprocessing = time_diff(built, time_now());
+
+        micro_t time = 0us;
+
+        for (int i = 0; i < iterations; ++i) {
+            now_t start = time_now();
+            astar_landmarks_weight(snap, context, landmarks, s, t);
+            now_t end = time_now();
+            time += time_diff(start, end);
+        }
+
+        auto total = time.count() / iterations;
+
+        std::cout << "--- (12) Weighted A* with landmarks (snapshot) ---" << std::endl;
+        std::cout << "Preprocessing: " << preprocessing.count() << " microseconds." << std::endl;
+        std::cout << "Average Time: " << total << " microseconds." << std::endl;
+    }
+
+    // Benchmark hub label distance queries, on the hierarchy's order
+    {
+        now_t built = time_now();
+        HubLabels labels(snap, graph->hierarchy());
+        micro_t preprocessing = time_diff(built, time_now());
+
+        double distance = 0;
+        now_t start = time_now();
+        for (int i = 0; i < iterations; ++i) {
+            distance += labels.distance(s, t);
+        }
+        now_t end = time_now();
+
+        auto total = double(time_diff(start, end).count()) / iterations;
+
+        std::cout << "--- (13) Hub labels (distance only) ---" << std::endl;
+        std::cout << "Preprocessing: " << preprocessing.count() << " microseconds ("
+                  << labels.average_label() << " average label, " << labels.max_label()
+                  << " max, " << labels.memory() / 1024 << " KB)." << std::endl;
+        std::cout << "Distance: " << distance / iterations << std::endl;
+        std::cout << "Average Time: " << total << " microseconds." << std::endl;
+    }
+
+    // Benchmark distance tables, from the source and the target to vertices
+    // spread over the map
+    {
+        std::size_t n = snap.size(), count = std::min<std::size_t>(TABLE_SIZE, n);
+        std::vector<int> sources{s}, targets{t};
+        for (std::size_t i = 1; i < count; ++i) {
+            sources.push_back(n * i / count);
+            targets.push_back((n * i / count + n / (2 * count)) % n);
+        }
+
+        std::vector<double> table(sources.size() * targets.size());
+        const ContractionHierarchy& hierarchy = graph->hierarchy();
+
+        micro_t dijkstra = 0us, buckets = 0us;
+
+        for (int i = 0; i < iterations; ++i) {
+            now_t start = time_now();
+            distance_table(snap, sources, targets, table.data());
+            now_t middle = time_now();
+            hierarchy.distance_table(sources, targets, table.data());
+            now_t end = time_now();
+            dijkstra += time_diff(start, middle);
+            buckets += time_diff(middle, end);
+        }
+
+        std::cout << "--- (14) Distance table " << count << "x" << count << " ---" << std::endl;
+        std::cout << "Distance: " << table[0 * targets.size() + 0] << std::endl;
+        std::cout << "Average Time (Dijkstra): " << dijkstra.count() / iterations
+                  << " microseconds." << std::endl;
+        std::cout << "Average Time (CH buckets): " << buckets.count() / iterations
+                  << " microseconds." << std::endl;
+    }
+
+    // Benchmark isochrones, as far as the target by length and by weight
+    {
+        dijkstra_early_exit(snap, context, s, t);
+        double length_budget = context.get_cost(t);
+        dijkstra_weight(snap, context, s, t);
+        double weight_budget = context.get_cost(t);
+
+        isochrone_t region;
+        micro_t length_time = 0us, weight_time = 0us;
+
+        for (int i = 0; i < iterations; ++i) {
+            now_t start = time_now();
+            isochrone(snap, context, s, length_budget, region);
+            now_t middle = time_now();
+            isochrone<policy::weight>(snap, context, s, weight_budget, region);
+            now_t end = time_now();
+            length_time += time_diff(start, middle);
+            weight_time += time_diff(middle, end);
+        }
+
+        std::cout << "--- (15) Isochrone ---" << std::endl;
+        std::cout << "Region (weight): " << region.vertices.size() << " vertices." << std::endl;
+        std::cout << "Average Time (length): " << length_time.count() / iterations
+                  << " microseconds." << std::endl;
+        std::cout << "Average Time (weight): " << weight_time.count() / iterations
+                  << " microseconds." << std::endl;
+    }
+
+    // Benchmark batches of queries between vertices spread over the map, on
+    // 1, 2, 4, ... threads up to every core
+    {
+        std::size_t n = snap.size();
+        std::vector<query_t> queries{{s, t}};
+        for (std::size_t i = 1; i < ROUTER_BATCH; ++i) {
+            queries.push_back({int(n * i / ROUTER_BATCH), int((n * i / ROUTER_BATCH + n / 2) % n)});
+        }
+
+        std::vector<double> costs(queries.size());
+        const ContractionHierarchy& hierarchy = graph->hierarchy();
+
+        unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<unsigned> counts;
+        for (unsigned threads = 1; threads < cores; threads *= 2) counts.push_back(threads);
+        counts.push_back(cores);
+
+        std::cout << "--- (16) Batch routing " << queries.size() << " queries ---" << std::endl;
+
+        for (unsigned threads : counts) {
+            BatchRouter astar(current, BatchRouter::engine::astar, nullptr, threads);
+            BatchRouter contracted(current, BatchRouter::engine::hierarchy, &hierarchy, threads);
+
+            micro_t astar_time = 0us, hierarchy_time = 0us;
+
+            for (int i = 0; i < iterations; ++i) {
+                now_t start = time_now();
+                astar.route(queries, costs.data());
+                now_t middle = time_now();
+                contracted.route(queries, costs.data());
+                now_t end = time_now();
+                astar_time += time_diff(start, middle);
+                hierarchy_time += time_diff(middle, end);
+            }
+
+            double total = 1e6 * iterations * queries.size();
+            std::cout << threads << " threads: "
+                      << std::size_t(total / astar_time.count()) << " queries/s (A*), "
+                      << std::size_t(total / hierarchy_time.count()) << " queries/s (CH)."
+                      << std::endl;
+        }
+    }
+
+    // Benchmark weighted Dijkstra with the binary heap against the integer
+    // queues on the weights in whole metres
+    {
+        RadixHeap radix(snap);
+        BucketQueue buckets(snap);
+
+        micro_t heap_time = 0us, radix_time = 0us, buckets_time = 0us;
+
+        for (int i = 0; i < iterations; ++i) {
+            now_t start = time_now();
+            dijkstra_weight(snap, context, s, t);
+            now_t first = time_now();
+            dijkstra_quantised(snap, context, radix, s, t);
+            now_t second = time_now();
+            dijkstra_quantised(snap, context, buckets, s, t);
+            now_t end = time_now();
+            heap_time += time_diff(start, first);
+            radix_time += time_diff(first, second);
+            buckets_time += time_diff(second, end);
+        }
+
+        std::cout << "--- (17) Quantised weighted Dijkstra ---" << std::endl;
+        std::cout << "Weight: " << context.get_cost(t) << std::endl;
+        std::cout << "Average Time (binary heap): " << heap_time.count() / iterations
+                  << " microseconds." << std::endl;
+        std::cout << "Average Time (radix heap): " << radix_time.count() / iterations
+                  << " microseconds." << std::endl;
+        std::cout << "Average Time (Dial buckets): " << buckets_time.count() / iterations
+                  << " microseconds." << std::endl;
+    }
+
+    // Benchmark Early Exit Dijkstra on every heap of MutablePriorityQueue.h
+    // and pick the fastest on this map
+    {
+        micro_t times[4] = {0us, 0us, 0us, 0us};
+        const char* names[4] = {"binary", "4-ary", "8-ary", "pairing"};
+
+        for (int i = 0; i < iterations; ++i) {
+            now_t start = time_now();
+            dijkstra_early_exit<DaryHeap<Vertex, 2>>(source, target);
+            graph->clear();
+            now_t first = time_now();
+            dijkstra_early_exit<DaryHeap<Vertex, 4>>(source, target);
+            graph->clear();
+            now_t second = time_now();
+            dijkstra_early_exit<DaryHeap<Vertex, 8>>(source, target);
+            graph->clear();
+            now_t third = time_now();
+            dijkstra_early_exit<PairingHeap<Vertex>>(source, target);
+            graph->clear();
+            now_t end = time_now();
+            times[0] += time_diff(start, first);
+            times[1] += time_diff(first, second);
+            times[2] += time_diff(second, third);
+            times[3] += time_diff(third, end);
+        }
+
+        int fastest = std::min_element(times, times + 4) - times;
+
+        std::cout << "--- (18) Heap policies ---" << std::endl;
+        for (int h = 0; h < 4; ++h) {
+            std::cout << "Average Time (" << names[h] << "): " << times[h].count() / iterations
+                      << " microseconds." << std::endl;
+        }
+        std::cout << "Fastest: " << names[fastest] << " heap." << std::endl;
+    }
+
+    // Benchmark Dijkstra on the context's lazy heap against the indexed heap
+    {
+        IndexedHeap<> heap(snap.size());
+
+        micro_t lazy_time = 0us, indexed_time = 0us;
+
+        for (int i = 0; i < iterations; ++i) {
+            now_t start = time_now();
+            dijkstra_early_exit(snap, context, s, t);
+            now_t middle = time_now();
+            dijkstra_indexed(snap, context, heap, s, t);
+            now_t end = time_now();
+            lazy_time += time_diff(start, middle);
+            indexed_time += time_diff(middle, end);
+        }
+
+        std::cout << "--- (19) Indexed heap Dijkstra ---" << std::endl;
+        std::cout << "Distance: " << context.get_cost(t) << std::endl;
+        std::cout << "Average Time (lazy heap): " << lazy_time.count() / iterations
+                  << " microseconds." << std::endl;
+        std::cout << "Average Time (indexed heap): " << indexed_time.count() / iterations
+                  << " microseconds." << std::endl;
+    }
+
+    // Benchmark weighted A*, trading path length for speed
+    {
+        const double factors[3] = {1.0, 1.5, 2.0};
+
+        std::cout << "--- (20) Weighted A* ---" << std::endl;
+
+        for (double factor : factors) {
+            micro_t time = 0us;
+
+            for (int i = 0; i < iterations; ++i) {
+                now_t start = time_now();
+                weighted_astar(snap, context, s, t, factor);
+                now_t end = time_now();
+                time += time_diff(start, end);
+            }
+
+            std::cout << "Factor " << factor << ": distance " << context.get_cost(t)
+                      << ", average time " << time.count() / iterations
+                      << " microseconds." << std::endl;
+        }
+    }
+
+    // Benchmark A* as a coroutine against the plain A*, the coroutine being
+    // drained to the end
+    {
+        micro_t plain_time = 0us, steps_time = 0us;
+        std::size_t settled = 0;
+
+        for (int i = 0; i < iterations; ++i) {
+            now_t start = time_now();
+            astar_search(snap, context, s, t);
+            now_t middle = time_now();
+            settled = 0;
+            for ([[maybe_unused]] int v : astar_steps(snap, context, s, t)) ++settled;
+            now_t end = time_now();
+            plain_time += time_diff(start, middle);
+            steps_time += time_diff(middle, end);
+        }
+
+        std::cout << "--- (21) A* step by step ---" << std::endl;
+        std::cout << "Settled: " << settled << " vertices." << std::endl;
+        std::cout << "Average Time (plain): " << plain_time.count() / iterations
+                  << " microseconds." << std::endl;
+        std::cout << "Average Time (coroutine): " << steps_time.count() / iterations
+                  << " microseconds." << std::endl;
+    }
+
     //discard();
 }
 
@@ -288,8 +905,8 @@ void paths() {
     graph->reset();
     std::cout << ui_string << std::endl;
 
-    int option = select_option(8);
-    if (option == 8 || option == 0) return;
+    int option = select_option(14);
+    if (option == 14 || option == 0) return;
 
     Vertex* source = select_source_vertex(true);
     if (source == nullptr) {
@@ -322,12 +939,30 @@ void paths() {
         do_astar_search(source, target);
         break;
     case 5:
-        do_edge_simulation(source, target);
+        do_bidirectional_dijkstra_search(source, target);
         break;
     case 6:
-        do_road_simulation(source, target);
+        do_bidirectional_astar_search(source, target);
         break;
     case 7:
+        do_contraction_hierarchy_search(source, target);
+        break;
+    case 8:
+        do_astar_landmarks_search(source, target);
+        break;
+    case 9:
+        do_isochrone_search(source, target);
+        break;
+    case 10:
+        do_astar_steps_search(source, target);
+        break;
+    case 11:
+        do_edge_simulation(source, target);
+        break;
+    case 12:
+        do_road_simulation(source, target);
+        break;
+    case 13:
         do_benchmark(source, target);
         break;
     }
@@ -13,6 +13,18 @@ void do_dijkstra_early_exit_search(Vertex* source, Vertex* target);
 
 void do_astar_search(Vertex* source, Vertex* target);
 
+void do_bidirectional_dijkstra_search(Vertex* source, Vertex* target);
+
+void do_bidirectional_astar_search(Vertex* source, Vertex* target);
+
+void do_contraction_hierarchy_search(Vertex* source, Vertex* target);
+
+void do_astar_landmarks_search(Vertex* source, Vertex* target);
+
+void do_isochrone_search(Vertex* source, Vertex* target);
+
+void do_astar_steps_search(Vertex* source, Vertex* target);
+
 void do_edge_simulation(Vertex* source, Vertex* target);
 
 void do_road_simulation(Vertex* source, Vertex* target);
@@ -83,13 +83,12 @@ static Road* extract_road_from_found(const roads_t& roads) {
 template <typename T>
 static Road* call_exact_search(exact_search_t<T> exact_search, const T& preprocessor) {
     // 1. Load road container.
-    auto road_map = graph->get_road_map();
+    const auto& road_map = graph->get_road_map();
 
     // 2. We will collect here all the roads with minimum fuzzy distance
     roads_t roads_found;
 
-    for (const auto& element : road_map) {
-        Road* road = element.second;
+    for (Road* road : road_map) {
         if (road->name().empty()) continue;
 
         // 3.1. Compute the matching indices.
@@ -107,7 +106,7 @@ static Road* call_exact_search(exact_search_t<T> exact_search, const T& preproce
 
 static Road* call_distance(distance_function_t distance_function, const std::string& road_name) {
     // 1. Load road container.
-    auto road_map = graph->get_road_map();
+    const auto& road_map = graph->get_road_map();
 
     // 2. We will collect here all the roads with minimum fuzzy distance
     roads_t roads_found;
@@ -115,8 +114,7 @@ static Road* call_distance(distance_function_t distance_function, const std::str
     // The minimum distance found so far
     std::size_t minimum = -1;
 
-    for (const auto& element : road_map) {
-        Road* road = element.second;
+    for (Road* road : road_map) {
         if (road->name().empty()) continue;
 
         // 3.1. Compute the distance of each road's name to the given one.
@@ -142,7 +140,7 @@ static Road* call_distance(distance_function_t distance_function, const std::str
 
 static Road* call_fuzzy_search(fuzzy_search_t fuzzy_search, const std::string& road_name) {
     // 1. Load road container.
-    auto road_map = graph->get_road_map();
+    const auto& road_map = graph->get_road_map();
 
     // 2. We will collect here all the roads with minimum fuzzy distance
     roads_t roads_found;
@@ -150,8 +148,7 @@ static Road* call_fuzzy_search(fuzzy_search_t fuzzy_search, const std::string& r
     // The minimum distance found so far
     std::size_t minimum = -1;
 
-    for (const auto& element : road_map) {
-        Road* road = element.second;
+    for (Road* road : road_map) {
         if (road->name().empty()) continue;
 
         // 3.1. Compute the distance of each road's name to the given one.
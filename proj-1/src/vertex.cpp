@@ -1,5 +1,7 @@
 #include "graph.h"
 
+#include <algorithm>
+
 Vertex::Vertex(int id, int x, int y):
     _id(id), _x(x), _y(y) {}
 
@@ -7,6 +9,10 @@ int Vertex::id() const {
     return _id;
 }
 
+int Vertex::index() const {
+    return _index;
+}
+
 int Vertex::x() const {
     return _x;
 }
@@ -48,20 +54,12 @@ Edge* Vertex::edge_to(Vertex* other) const {
         if (edge->target() == other) return edge;
     }
 
-    for (Edge* edge : _acc_out) {
-        if (edge->target() == other) return edge;
-    }
-
     return nullptr;
 }
 
 Edge* Vertex::edge_from(Vertex* other) const {
     for (Edge* edge : _in) {
-        if (edge->target() == other) return edge;
-    }
-
-    for (Edge* edge : _acc_in) {
-        if (edge->target() == other) return edge;
+        if (edge->source() == other) return edge;
     }
 
     return nullptr;
@@ -75,19 +73,45 @@ bool Vertex::connects_from(Vertex* other) const {
     return edge_from(other) != nullptr;
 }
 
+/**
+ * Number of clear incident edges.
+ */
 std::size_t Vertex::in_degree() const {
-    return _in.size();
+    return std::count_if(_in.begin(), _in.end(), [](Edge* e) { return e->is_clear(); });
 }
 
+/**
+ * Number of clear outgoing edges.
+ */
 std::size_t Vertex::out_degree() const {
-    return _out.size();
+    return std::count_if(_out.begin(), _out.end(), [](Edge* e) { return e->is_clear(); });
+}
+
+/**
+ * The clear incident edges.
+ */
+ClearEdges Vertex::incident() const {
+    return ClearEdges(_in);
+}
+
+/**
+ * The clear outgoing edges.
+ */
+ClearEdges Vertex::outgoing() const {
+    return ClearEdges(_out);
 }
 
-const std::unordered_set<Edge*>& Vertex::incident() const {
+/**
+ * All incident edges, accidented ones included.
+ */
+const EdgeList& Vertex::all_incident() const {
     return _in;
 }
 
-const std::unordered_set<Edge*>& Vertex::outgoing() const {
+/**
+ * All outgoing edges, accidented ones included.
+ */
+const EdgeList& Vertex::all_outgoing() const {
     return _out;
 }
 
@@ -95,28 +119,52 @@ double Vertex::distance(Vertex* other) const {
     return _graph->distance(const_cast<Vertex*>(this), other);
 }
 
+/**
+ * Whether this vertex's search state belongs to the current query, i.e. it
+ * was written since the last Graph::clear().
+ */
+bool Vertex::is_current() const {
+    return _generation == _graph->_generation;
+}
+
+/**
+ * Claims the search state for the current query, resetting it if it
+ * belongs to an earlier one.
+ */
+void Vertex::touch() {
+    if (!is_current()) {
+        _generation = _graph->_generation;
+        _path = nullptr;
+        _priority = 0;
+        _cost = 0;
+    }
+}
+
 void Vertex::set_path(Vertex* previous) {
+    touch();
     _path = previous;
 }
 
 void Vertex::set_priority(double priority) {
+    touch();
     _priority = priority;
 }
 
 void Vertex::set_cost(double cost) {
+    touch();
     _cost = cost;
 }
 
 Vertex* Vertex::get_path() const {
-    return _path;
+    return is_current() ? _path : nullptr;
 }
 
 double Vertex::get_priority() const {
-    return _priority;
+    return is_current() ? _priority : 0;
 }
 
 double Vertex::get_cost() const {
-    return _cost;
+    return is_current() ? _cost : 0;
 }
 
 bool operator<(const Vertex& v1, const Vertex& v2) {